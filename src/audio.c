@@ -2,6 +2,7 @@
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
+#include "profiler.h"
 
 static AudioStream spawnStream;
 static AudioStream bounceStream;
@@ -16,6 +17,7 @@ static float baseFrequency = 880.0f;
 static float bounceVelocity = 0.0f;
 
 void SpawnAudioCallback(void *buffer, unsigned int frames) {
+    PROFILE_ZONE("SpawnAudioCallback");
     if (!isPlaying) {
         memset(buffer, 0, frames * sizeof(short) * 2); // Stereo buffer
         return;
@@ -72,6 +74,7 @@ void SpawnAudioCallback(void *buffer, unsigned int frames) {
 }
 
 void BounceAudioCallback(void *buffer, unsigned int frames) {
+    PROFILE_ZONE("BounceAudioCallback");
     if (!bouncePlaying) {
         memset(buffer, 0, frames * sizeof(short) * 2); // Stereo buffer
         return;
@@ -0,0 +1,188 @@
+#include "contacts.h"
+#include "memtrack.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CONTACT_MIN_CAPACITY 256
+
+// splitmix64 finalizer over both halves of the key
+static inline uint64_t hash_pair(uint64_t a, uint64_t b) {
+    uint64_t x = a * 0x9E3779B97F4A7C15ull ^ b;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+static int home_slot(uint64_t a, uint64_t b, int capacity) {
+    return (int)(hash_pair(a, b) & (uint64_t)(capacity - 1));
+}
+
+static Contact* find_slot(Contact* slots, int capacity, uint64_t a, uint64_t b) {
+    const int mask = capacity - 1;
+    int i = home_slot(a, b, capacity);
+    while (slots[i].a != 0 && (slots[i].a != a || slots[i].b != b)) {
+        i = (i + 1) & mask;
+    }
+    return &slots[i];
+}
+
+// Move every contact into a larger array
+static void grow(ContactTable* table, int capacity) {
+    Contact* fresh = memtrack_calloc(MEMTRACK_CONTACTS, capacity, sizeof(Contact));
+    if (!fresh) return;
+
+    for (int i = 0; i < table->capacity; i++) {
+        const Contact* c = &table->slots[i];
+        if (c->a != 0) *find_slot(fresh, capacity, c->a, c->b) = *c;
+    }
+
+    memtrack_free(table->slots);
+    table->slots = fresh;
+    table->capacity = capacity;
+}
+
+// Empty one slot without tombstones: later contacts of the probe run that may
+// live in the hole move back into it (backward-shift deletion)
+static void remove_slot(ContactTable* table, int hole) {
+    const int mask = table->capacity - 1;
+    for (int i = (hole + 1) & mask; table->slots[i].a != 0; i = (i + 1) & mask) {
+        // A contact may fill the hole unless its home lies cyclically in (hole, i]
+        const int home = home_slot(table->slots[i].a, table->slots[i].b, table->capacity);
+        const bool stays = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (stays) continue;
+
+        table->slots[hole] = table->slots[i];
+        hole = i;
+    }
+    table->slots[hole] = (Contact){0};
+    table->count--;
+}
+
+static bool held_contains(const ContactTable* table, uint64_t body) {
+    if (table->held_count == 0) return false;
+    const int mask = table->held_capacity - 1;
+    for (int i = (int)(hash_pair(body, 0) & (uint64_t)mask); table->held[i] != 0; i = (i + 1) & mask) {
+        if (table->held[i] == body) return true;
+    }
+    return false;
+}
+
+static void push_event(ContactTable* table, ContactEventType type, const Contact* contact) {
+    if (table->event_count == table->event_capacity) {
+        table->event_capacity = table->event_capacity ? table->event_capacity * 2 : CONTACT_MIN_CAPACITY;
+        table->events = memtrack_realloc(MEMTRACK_CONTACTS, table->events, sizeof(ContactEvent) * table->event_capacity);
+    }
+
+    table->events[table->event_count++] = (ContactEvent){
+        type, contact->a, contact->b, type == CONTACT_EXIT ? 0.0f : contact->impact_speed
+    };
+}
+
+void contact_table_free(ContactTable* table) {
+    memtrack_free(table->slots);
+    memtrack_free(table->events);
+    memtrack_free(table->held);
+    memset(table, 0, sizeof(*table));
+}
+
+void contact_table_clear(ContactTable* table) {
+    if (table->slots) memset(table->slots, 0, sizeof(Contact) * table->capacity);
+    table->count = 0;
+    table->event_count = 0;
+    if (table->held_count > 0) memset(table->held, 0, sizeof(uint64_t) * table->held_capacity);
+    table->held_count = 0;
+}
+
+void contact_table_begin_frame(ContactTable* table) {
+    // Frame 0 is never current, so zeroed slots can't look touched
+    table->frame++;
+    if (table->held_count > 0) memset(table->held, 0, sizeof(uint64_t) * table->held_capacity);
+    table->held_count = 0;
+}
+
+void contact_table_hold(ContactTable* table, uint64_t body) {
+    // Grow at 50% load
+    if ((table->held_count + 1) * 2 > table->held_capacity) {
+        const int capacity = table->held_capacity ? table->held_capacity * 2 : CONTACT_MIN_CAPACITY;
+        uint64_t* fresh = memtrack_calloc(MEMTRACK_CONTACTS, capacity, sizeof(uint64_t));
+        if (!fresh) return;
+
+        for (int i = 0; i < table->held_capacity; i++) {
+            const uint64_t held = table->held[i];
+            if (held == 0) continue;
+            int slot = (int)(hash_pair(held, 0) & (uint64_t)(capacity - 1));
+            while (fresh[slot] != 0) slot = (slot + 1) & (capacity - 1);
+            fresh[slot] = held;
+        }
+        memtrack_free(table->held);
+        table->held = fresh;
+        table->held_capacity = capacity;
+    }
+
+    const int mask = table->held_capacity - 1;
+    int i = (int)(hash_pair(body, 0) & (uint64_t)mask);
+    while (table->held[i] != 0) {
+        if (table->held[i] == body) return;
+        i = (i + 1) & mask;
+    }
+    table->held[i] = body;
+    table->held_count++;
+}
+
+Contact* contact_table_touch(ContactTable* table, uint64_t a, uint64_t b) {
+    if (a > b) {
+        uint64_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    // Grow at 70% load
+    if (!table->slots || (table->count + 1) * 10 > table->capacity * 7) {
+        grow(table, table->capacity ? table->capacity * 2 : CONTACT_MIN_CAPACITY);
+        if (!table->slots || table->count + 1 >= table->capacity) return NULL;
+    }
+
+    Contact* contact = find_slot(table->slots, table->capacity, a, b);
+    if (contact->a == 0) {
+        *contact = (Contact){.a = a, .b = b, .first_frame = table->frame};
+        table->count++;
+    }
+
+    contact->last_frame = table->frame;
+
+    return contact;
+}
+
+void contact_table_end_frame(ContactTable* table) {
+    table->event_count = 0;
+
+    int first_exit = -1;
+    for (int i = 0; i < table->capacity; i++) {
+        Contact* c = &table->slots[i];
+        if (c->a == 0) continue;
+
+        // Pairs of two held bodies weren't checked, so they are assumed to persist
+        if (c->last_frame != table->frame && held_contains(table, c->a) && held_contains(table, c->b)) {
+            c->last_frame = table->frame;
+        }
+
+        if (c->last_frame != table->frame) {
+            push_event(table, CONTACT_EXIT, c);
+            if (first_exit < 0) first_exit = table->event_count - 1;
+        } else {
+            push_event(table, contact_is_new(table, c) ? CONTACT_ENTER : CONTACT_STAY, c);
+        }
+    }
+
+    // Drop the exited pairs one by one, so the cost follows the number of exits.
+    // Deleting during the scan could shift an unvisited contact behind it.
+    for (int e = first_exit; e >= 0 && e < table->event_count; e++) {
+        const ContactEvent* event = &table->events[e];
+        if (event->type != CONTACT_EXIT) continue;
+        Contact* c = find_slot(table->slots, table->capacity, event->a, event->b);
+        remove_slot(table, (int)(c - table->slots));
+    }
+}
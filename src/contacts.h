@@ -0,0 +1,76 @@
+#ifndef CONTACTS_H
+#define CONTACTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Persistent contact table keyed by body pair.
+// The narrow phase touches every pair in contact once per frame; at the end of
+// the frame the table publishes a batch of enter/stay/exit events and forgets
+// pairs that were not touched.
+
+typedef enum {
+    CONTACT_ENTER, // First frame in contact
+    CONTACT_STAY,  // Still in contact
+    CONTACT_EXIT   // Was in contact last frame, not this one
+} ContactEventType;
+
+typedef struct {
+    uint64_t a;              // Pair key, a < b (0 marks an empty slot)
+    uint64_t b;
+    float impact_speed;      // Closing speed along the normal when touched
+    unsigned int first_frame;
+    unsigned int last_frame;
+} Contact;
+
+typedef struct {
+    ContactEventType type;
+    uint64_t a;
+    uint64_t b;
+    float impact_speed;      // Closing speed at the touch (0 for exits)
+} ContactEvent;
+
+typedef struct {
+    Contact* slots;          // Open addressing, linear probing; capacity is a power of two
+    int capacity;
+    int count;
+    unsigned int frame;
+    ContactEvent* events;    // Events of the last finished frame
+    int event_count;
+    int event_capacity;
+    uint64_t* held;          // Bodies held this frame (contact_table_hold), open addressing
+    int held_count;
+    int held_capacity;
+} ContactTable;
+
+// === Lifecycle ===
+
+// Zero-initialized tables are valid; storage grows on demand
+void contact_table_free(ContactTable* table);
+
+// Forget every contact without emitting exits, keeping the storage (state restored
+// from a snapshot has no contact history)
+void contact_table_clear(ContactTable* table);
+
+// === Per frame ===
+
+void contact_table_begin_frame(ContactTable* table);
+
+// Find or create the contact for a pair (order of a/b doesn't matter).
+// The pointer is valid until the next touch or end of frame; NULL if out of memory.
+Contact* contact_table_touch(ContactTable* table, uint64_t a, uint64_t b);
+
+// Mark a body whose pairs aren't checked this frame (asleep, or not due). Its
+// contacts with other held bodies stay as they are instead of exiting.
+void contact_table_hold(ContactTable* table, uint64_t body);
+
+// Publish this frame's events and forget pairs that weren't touched
+void contact_table_end_frame(ContactTable* table);
+
+// === Queries ===
+
+static inline bool contact_is_new(const ContactTable* table, const Contact* contact) {
+    return contact->first_frame == table->frame;
+}
+
+#endif // CONTACTS_H
@@ -0,0 +1,90 @@
+#include "frame_arena.h"
+#include "memtrack.h"
+
+struct FrameArenaOverflow {
+    FrameArenaOverflow* next;
+    size_t size;
+};
+
+static size_t align_up(size_t size) {
+    return (size + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+}
+
+// === Single arena ===
+
+void* frame_arena_alloc(FrameArena* arena, size_t size) {
+    size = align_up(size ? size : 1);
+    arena->frame_bytes += size;
+    if (arena->frame_bytes > arena->peak_bytes) arena->peak_bytes = arena->frame_bytes;
+
+    if (!arena->base && arena->overflow == NULL) {
+        // First use: size the block for this request
+        arena->capacity = size > FRAME_ARENA_MIN_CAPACITY ? align_up(size * 2) : FRAME_ARENA_MIN_CAPACITY;
+        arena->base = memtrack_alloc(MEMTRACK_SCRATCH, arena->capacity);
+        if (!arena->base) arena->capacity = 0;
+    }
+
+    if (arena->base && arena->used + size <= arena->capacity) {
+        void* ptr = arena->base + arena->used;
+        arena->used += size;
+        return ptr;
+    }
+
+    // Doesn't fit: a separate block until the next reset grows the arena
+    const size_t header = align_up(sizeof(FrameArenaOverflow));
+    FrameArenaOverflow* block = memtrack_alloc(MEMTRACK_SCRATCH, header + size);
+    if (!block) return NULL;
+    block->size = size;
+    block->next = arena->overflow;
+    arena->overflow = block;
+    return (unsigned char*)block + header;
+}
+
+void frame_arena_reset(FrameArena* arena) {
+    if (arena->overflow) {
+        while (arena->overflow) {
+            FrameArenaOverflow* next = arena->overflow->next;
+            memtrack_free(arena->overflow);
+            arena->overflow = next;
+        }
+
+        // Grow once, with headroom, so the same frame fits next time
+        memtrack_free(arena->base);
+        arena->capacity = align_up(arena->peak_bytes + arena->peak_bytes / 2);
+        arena->base = memtrack_alloc(MEMTRACK_SCRATCH, arena->capacity);
+        if (!arena->base) arena->capacity = 0;
+    }
+
+    arena->used = 0;
+    arena->frame_bytes = 0;
+}
+
+void frame_arena_free(FrameArena* arena) {
+    frame_arena_reset(arena);
+    memtrack_free(arena->base);
+    *arena = (FrameArena){0};
+}
+
+// === Per-frame scratch ===
+
+static FrameArena g_scratch[2];
+static int g_scratch_current = 0;
+
+void* frame_scratch_alloc(size_t size) {
+    return frame_arena_alloc(&g_scratch[g_scratch_current], size);
+}
+
+void frame_scratch_swap(void) {
+    g_scratch_current ^= 1;
+    frame_arena_reset(&g_scratch[g_scratch_current]);
+}
+
+const FrameArena* frame_scratch_current(void) {
+    return &g_scratch[g_scratch_current];
+}
+
+void frame_scratch_free(void) {
+    frame_arena_free(&g_scratch[0]);
+    frame_arena_free(&g_scratch[1]);
+    g_scratch_current = 0;
+}
@@ -0,0 +1,56 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <stddef.h>
+
+// Linear scratch memory for data that lives for one frame.
+//
+// Allocation bumps an offset in one block; nothing is freed individually and a
+// reset just rewinds the offset. When a frame asks for more than the block holds,
+// the excess comes from separate overflow blocks, and the next reset replaces the
+// block with one big enough for that frame, so a steady workload settles on a
+// single block and allocates nothing from the heap.
+
+#define FRAME_ARENA_ALIGNMENT 16
+#define FRAME_ARENA_MIN_CAPACITY (64 * 1024)
+
+typedef struct FrameArenaOverflow FrameArenaOverflow;
+
+typedef struct {
+    unsigned char* base;
+    size_t capacity;
+    size_t used;                  // Bytes taken from base this frame
+    size_t frame_bytes;           // Bytes requested this frame, overflow included
+    size_t peak_bytes;            // Highest frame_bytes so far
+    FrameArenaOverflow* overflow; // Blocks that didn't fit in base this frame
+} FrameArena;
+
+// === Single arena ===
+
+// Zero-initialized arenas are valid; storage is allocated on first use.
+// Returns FRAME_ARENA_ALIGNMENT-aligned memory, or NULL if out of memory.
+void* frame_arena_alloc(FrameArena* arena, size_t size);
+
+// Forget everything allocated since the last reset. O(1) unless the frame overflowed.
+void frame_arena_reset(FrameArena* arena);
+
+void frame_arena_free(FrameArena* arena);
+
+// === Per-frame scratch ===
+//
+// Two arenas used alternately: memory from frame_scratch_alloc stays valid until
+// the end of the frame after the one it was allocated in, so a consumer one frame
+// behind (a pipelined renderer) can still read it. Allocate and swap only on
+// the thread running the simulation.
+
+void* frame_scratch_alloc(size_t size);
+
+// End of frame: the arena of the previous frame is reset and becomes current
+void frame_scratch_swap(void);
+
+// The arena frame_scratch_alloc currently allocates from
+const FrameArena* frame_scratch_current(void);
+
+void frame_scratch_free(void);
+
+#endif // FRAME_ARENA_H
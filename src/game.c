@@ -0,0 +1,1371 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <flecs.h>
+#include <raylib.h>
+#include "raymath.h"
+#include "audio.h"
+#include "spatial.h"
+#include "neighbors.h"
+#include "contacts.h"
+#include "sectors.h"
+#include "snapshot.h"
+#include "jobs.h"
+#include "profiler.h"
+#include "memtrack.h"
+#include "frame_arena.h"
+#include "game.h"
+
+// Spatial partitioning globals
+Quadtree *g_quadtree = NULL;
+TweenPool g_tweens = {0};
+
+// Neighbor lists shared by collision and flocking, and the entity each row
+// belongs to so reused (Verlet) lists can detect a changed body set
+static NeighborList g_neighbors;
+static ecs_entity_t *g_neighborEntities = NULL;
+static int g_neighborEntityCapacity = 0;
+
+// Contacts persist across ticks for enter/stay/exit events
+static ContactTable g_contacts;
+
+// Cached queries, created with the world in GameInit: a query created per tick
+// allocates from the heap every tick and has to match its tables again
+static ecs_query_t *g_bodyQuery = NULL;
+static ecs_query_t *g_hashQuery = NULL;
+
+// How far bodies may be from where the quadtree saw them, for queries made
+// after the physics step (rendering)
+static float g_quadtreeSlack = 0.0f;
+static int g_quadtreeBodyCount = 0;
+
+// A quadtree and the bodies it was built from, in physics order
+typedef struct {
+    Quadtree *tree;
+    AABB arena;
+    ecs_entity_t *entity;
+    Vector2 *position;
+    float *radius;
+    float *mass; // Only enemies carry mass for NBODY; the player neither pulls nor is pulled
+    int count;
+    int capacity;
+} QuadtreeBuild;
+
+// The front build is g_quadtree. With GameState.backgroundQuadtree the back one is
+// built by a job from a tick's final positions while the rest of the frame runs,
+// and swapped in at the start of the next tick if the bodies still match.
+static QuadtreeBuild g_treeFront;
+static QuadtreeBuild g_treeBack;
+static JobCounter g_treeBackDone;
+static bool g_treeBackPending = false;
+
+// Spawn defaults shared by every enemy (SpawnEnemies)
+static ecs_entity_t g_enemyPrefab = 0;
+
+// Profiles in g_tweens
+static int g_spawnSpring = -1;
+static int g_destructionSpring = -1;
+
+GameSystem g_game_systems[GAME_MAX_SYSTEMS];
+int g_game_system_count = 0;
+
+ECS_COMPONENT_DECLARE(Health);
+ECS_COMPONENT_DECLARE(Velocity);
+ECS_COMPONENT_DECLARE(PlayerInput);
+ECS_COMPONENT_DECLARE(EnemyInput);
+ECS_COMPONENT_DECLARE(Renderable);
+ECS_COMPONENT_DECLARE(RadiusTween);
+ECS_COMPONENT_DECLARE(AttractionRangeVFX);
+ECS_COMPONENT_DECLARE(Spike);
+ECS_COMPONENT_DECLARE(Mortal);
+ECS_COMPONENT_DECLARE(Sleep);
+ECS_COMPONENT_DECLARE(GameState);
+
+void TriggerDestruction(ecs_world_t *world, ecs_entity_t entity) {
+    // Spring the radius down to 0 from wherever it is (RadiusTweenSystem deletes the
+    // entity once it gets there)
+    const Renderable *r = ecs_get(world, entity, Renderable);
+    RadiusTween *tween = ecs_get_mut(world, entity, RadiusTween);
+    if (r && tween) {
+        tween_stop(&g_tweens, tween->handle, entity);
+        tween->handle = tween_start(&g_tweens, g_destructionSpring, entity, r->radius, 0.0f, 0.0f);
+    }
+
+    // PlayDesctructionSound();
+}
+
+const ContactEvent *GameContactEvents(int *count) {
+    *count = g_contacts.event_count;
+    return g_contacts.events;
+}
+
+void WakeBody(Sleep *sleep) {
+    sleep->asleep = false;
+    sleep->restTime = 0;
+}
+
+void PlayerMovementSystem(ecs_iter_t *it) {
+    PROFILE_ZONE("PlayerMovementSystem");
+    Velocity *v = ecs_field(it, Velocity, 0);
+    GameState *state = ecs_singleton_get_mut(it->world, GameState);
+    const unsigned int input = state->input;
+
+    float speed = 0.0f;
+
+    for (int i = 0; i < it->count; i++) {
+        const float PLAYER_SPEED = 200.0f;
+        const float ACCELERATION = 2.0f; // Higher = faster acceleration
+        Vector2 direction = {0, 0};
+
+        if (input & INPUT_RIGHT) direction.x = 1.0f;
+        if (input & INPUT_LEFT) direction.x = -1.0f;
+        if (input & INPUT_UP) direction.y = -1.0f;
+        if (input & INPUT_DOWN) direction.y = 1.0f;
+
+        // Calculate target velocity
+        Vector2 targetVelocity;
+        float magnitude = Vector2Length(direction);
+        if (magnitude > 0) {
+            direction = Vector2Scale(direction, 1.0f / magnitude);
+            targetVelocity = Vector2Scale(direction, PLAYER_SPEED);
+        } else {
+            targetVelocity = (Vector2){0, 0};
+        }
+
+        // Smoothly interpolate current velocity towards target
+        v[i].velocity.x += (targetVelocity.x - v[i].velocity.x) * ACCELERATION * it->delta_time;
+        v[i].velocity.y += (targetVelocity.y - v[i].velocity.y) * ACCELERATION * it->delta_time;
+
+        speed = Vector2Length(v[i].velocity);
+    }
+
+    state->targetZoom = 1.0f - speed * 0.001f;
+    state->zoom = state->targetZoom;
+    // float smoothSpeed = 10.0f; // Higher = faster transition
+    // state->zoom += (state->targetZoom - state->zoom) * smoothSpeed * it->delta_time;
+}
+
+void EnemyMovementSystem(ecs_iter_t *it) {
+    PROFILE_ZONE("EnemyMovementSystem");
+    Velocity *v = ecs_field(it, Velocity, 0);
+    EnemyInput *e = ecs_field(it, EnemyInput, 1);
+    const Renderable *r = ecs_field(it, Renderable, 2);
+    Sleep *sleep = ecs_field_is_set(it, 3) ? ecs_field(it, Sleep, 3) : NULL;
+
+    const ecs_world_t *world = it->world;
+    const ecs_entity_t player = ecs_lookup(world, "Player");
+    const ecs_id_t renderable_id = ecs_field_id(it, 2);
+    const Renderable *playerRenderable = ecs_get_id(world, player, renderable_id);
+    const Vector2 playerPos = playerRenderable->position;
+    const Velocity *playerVelocity = ecs_get(world, player, Velocity);
+
+    GameState *state = ecs_singleton_get_mut(it->world, GameState);
+    const float MAX_ATTRACTION_RANGE = (float) MIN(state->screenWidth, state->screenHeight) / 2;
+
+    // The attraction force on resting bodies changes when it is toggled or the player moves
+    const bool attracting = (state->input & INPUT_ATTRACT) != 0;
+    const bool attractionChanged = attracting != ((state->prevInput & INPUT_ATTRACT) != 0) ||
+                                   (attracting && playerVelocity &&
+                                    Vector2Length(playerVelocity->velocity) > SLEEP_VELOCITY_THRESHOLD);
+
+    for (int i = 0; i < it->count; i++) {
+        if (sleep && sleep[i].asleep) {
+            const float distance = Vector2Distance(playerPos, r[i].position);
+            if (!attractionChanged || distance >= MAX_ATTRACTION_RANGE) {
+                continue;
+            }
+            WakeBody(&sleep[i]);
+        }
+
+        const float ENEMY_SPEED = 100.0f;
+        if (!e[i].directionSet && ENEMY_SPEED > 0) {
+            e[i].directionSet = true;
+            v[i].velocity = (Vector2){
+                .x = (float) GameRandomValue(state, -(int) ENEMY_SPEED, (int) ENEMY_SPEED),
+                .y = (float) GameRandomValue(state, -(int) ENEMY_SPEED, (int) ENEMY_SPEED)
+            };
+        }
+
+        if (attracting) {
+            const float MAX_ATTRACTION_FORCE = 5.0f;
+            Vector2 dir = {
+                .x = playerPos.x - r[i].position.x,
+                .y = playerPos.y - r[i].position.y
+            };
+
+            const float magnitude = sqrtf(dir.x * dir.x + dir.y * dir.y);
+
+            // Normalize direction
+            if (magnitude > 0) {
+                dir.x /= magnitude;
+                dir.y /= magnitude;
+            }
+
+            float attractionStrength = fmaxf(0, 1.0f - (magnitude / MAX_ATTRACTION_RANGE));
+            Vector2 attractionForce = (Vector2){
+                dir.x * MAX_ATTRACTION_FORCE * attractionStrength,
+                dir.y * MAX_ATTRACTION_FORCE * attractionStrength
+            };
+            v[i].velocity = Vector2Add(v[i].velocity, attractionForce);
+        }
+    }
+}
+
+// Physics bodies. Each tick gathers flecs storage pointers, then copies the hot
+// fields into arrays in Morton order. The order persists while the gathered
+// entities stay the same, and is recomputed when it becomes too disordered.
+typedef struct {
+    ecs_entity_t entity;
+    Renderable *renderable; // Flecs storage, written back after the step
+    Velocity *velocity;
+    Sleep *sleep; // NULL for bodies that never sleep (player)
+    bool isEnemy;
+    bool hasNeighbors; // False if asleep when the neighbor lists were built
+    SimLod lod;
+    float stepDt; // Time this body advances this tick; 0 = not its turn (LOD)
+} BodyRef;
+
+typedef struct {
+    BodyRef *gathered; // This tick, in flecs storage order (frame scratch)
+    ecs_entity_t *orderEntities; // Gathered entities when order was computed
+    int *order; // Physics index -> gather index
+    BodyRef *ref; // Physics order
+    Vector2 *position; // Hot copies, physics order
+    Vector2 *velocity;
+    float *radius;
+    int orderCount; // Bodies covered by order
+    int capacity;
+} PhysicsBodies;
+
+static PhysicsBodies g_bodies;
+
+static void ReserveBodies(int count) {
+    if (count <= g_bodies.capacity) return;
+
+    int capacity = g_bodies.capacity ? g_bodies.capacity : 256;
+    while (capacity < count) capacity *= 2;
+
+    g_bodies.orderEntities = memtrack_realloc(MEMTRACK_PHYSICS, g_bodies.orderEntities, sizeof(ecs_entity_t) * capacity);
+    g_bodies.order = memtrack_realloc(MEMTRACK_PHYSICS, g_bodies.order, sizeof(int) * capacity);
+    g_bodies.ref = memtrack_realloc(MEMTRACK_PHYSICS, g_bodies.ref, sizeof(BodyRef) * capacity);
+    g_bodies.position = memtrack_realloc(MEMTRACK_PHYSICS, g_bodies.position, sizeof(Vector2) * capacity);
+    g_bodies.velocity = memtrack_realloc(MEMTRACK_PHYSICS, g_bodies.velocity, sizeof(Vector2) * capacity);
+    g_bodies.radius = memtrack_realloc(MEMTRACK_PHYSICS, g_bodies.radius, sizeof(float) * capacity);
+    g_bodies.capacity = capacity;
+}
+
+static void FreeBodies(void) {
+    memtrack_free(g_bodies.orderEntities);
+    memtrack_free(g_bodies.order);
+    memtrack_free(g_bodies.ref);
+    memtrack_free(g_bodies.position);
+    memtrack_free(g_bodies.velocity);
+    memtrack_free(g_bodies.radius);
+    g_bodies = (PhysicsBodies){0};
+}
+
+// Recompute the physics order when the gathered bodies changed or too many
+// consecutive bodies run backwards along the Morton curve. Returns true if sorted.
+static bool SortBodiesIfDisordered(int count, AABB arena) {
+    const BodyRef *gathered = g_bodies.gathered;
+
+    bool sameBodies = count == g_bodies.orderCount;
+    for (int i = 0; i < count && sameBodies; i++) {
+        sameBodies = g_bodies.orderEntities[i] == gathered[i].entity;
+    }
+
+    if (sameBodies) {
+        int descents = 0;
+        unsigned int previous = 0;
+        for (int k = 0; k < count; k++) {
+            const unsigned int code = spatial_morton_code(arena, gathered[g_bodies.order[k]].renderable->position);
+            if (code < previous) descents++;
+            previous = code;
+        }
+        if (descents <= count * SPATIAL_SORT_DISORDER) return false;
+    }
+
+    unsigned int *codes = frame_scratch_alloc(sizeof(unsigned int) * (count ? count : 1));
+    for (int i = 0; i < count; i++) {
+        codes[i] = spatial_morton_code(arena, gathered[i].renderable->position);
+        g_bodies.orderEntities[i] = gathered[i].entity;
+    }
+    spatial_sort_by_code(codes, count, g_bodies.order);
+    g_bodies.orderCount = count;
+    return true;
+}
+
+static void ReserveQuadtreeBuild(QuadtreeBuild *build, int count) {
+    if (count <= build->capacity) return;
+
+    build->entity = memtrack_realloc(MEMTRACK_SPATIAL, build->entity, sizeof(ecs_entity_t) * count);
+    build->position = memtrack_realloc(MEMTRACK_SPATIAL, build->position, sizeof(Vector2) * count);
+    build->radius = memtrack_realloc(MEMTRACK_SPATIAL, build->radius, sizeof(float) * count);
+    build->mass = memtrack_realloc(MEMTRACK_SPATIAL, build->mass, sizeof(float) * count);
+    build->capacity = count;
+}
+
+// Copy the bodies a tree is to be built from
+static void CaptureQuadtreeBodies(QuadtreeBuild *build, AABB arena, const BodyRef *bodies,
+                                  const Vector2 *positions, const float *radii, int count) {
+    ReserveQuadtreeBuild(build, count);
+    build->arena = arena;
+    build->count = count;
+    for (int i = 0; i < count; i++) {
+        build->entity[i] = bodies[i].entity;
+        build->position[i] = positions[i];
+        build->radius[i] = radii[i];
+        build->mass[i] = bodies[i].isEnemy ? 1.0f : 0.0f;
+    }
+}
+
+static void BuildQuadtree(QuadtreeBuild *build) {
+    if (build->tree == NULL) {
+        build->tree = quadtree_create(build->arena);
+    } else {
+        quadtree_clear(build->tree);
+        // Update world bounds in case screen size or zoom changed
+        build->tree->world_bounds = build->arena;
+        // Also update the root node's bounds to match
+        if (build->tree->root) {
+            build->tree->root->bounds = build->arena;
+        }
+    }
+
+    // Sleeping bodies are inserted too, so awake bodies can find and wake them
+    for (int i = 0; i < build->count; i++) {
+        quadtree_insert_with_mass(build->tree, i, aabb_from_circle(build->position[i], build->radius[i]),
+                                  build->mass[i]);
+    }
+}
+
+static void BuildQuadtreeJob(void *data) {
+    PROFILE_ZONE("QuadtreeBuildBackground");
+    BuildQuadtree(data);
+}
+
+// Whether a tree indexes exactly these bodies in this order, over this arena
+static bool QuadtreeBuildMatches(const QuadtreeBuild *build, AABB arena, const BodyRef *bodies, int count) {
+    if (build->tree == NULL || build->count != count ||
+        memcmp(&build->arena, &arena, sizeof(arena)) != 0) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (build->entity[i] != bodies[i].entity) return false;
+    }
+    return true;
+}
+
+static void WaitBackgroundQuadtree(void) {
+    if (!g_treeBackPending) return;
+    PROFILE_ZONE("QuadtreeWaitBackground");
+    jobs_wait(&g_treeBackDone);
+    g_treeBackPending = false;
+}
+
+static void FreeQuadtreeBuild(QuadtreeBuild *build) {
+    if (build->tree) quadtree_destroy(build->tree);
+    memtrack_free(build->entity);
+    memtrack_free(build->position);
+    memtrack_free(build->radius);
+    memtrack_free(build->mass);
+    *build = (QuadtreeBuild){0};
+}
+
+// NBODY gravity for a range of bodies. Each body only writes its own velocity
+// and the tree is read-only here, so ranges can run on any thread in any order.
+typedef struct {
+    const BodyRef *bodies;
+    const Vector2 *positions;
+    Vector2 *velocities;
+    float openingAngle;
+    float strength;
+} GravityJob;
+
+static void GravityRange(void *data, int begin, int end) {
+    PROFILE_ZONE("GravityRange");
+    const GravityJob *job = data;
+
+    for (int i = begin; i < end; i++) {
+        if (!job->bodies[i].isEnemy || job->bodies[i].stepDt == 0) continue;
+
+        const Vector2 acc = quadtree_gravity(g_quadtree, job->positions[i], i,
+                                             job->openingAngle, NBODY_SOFTENING);
+        job->velocities[i].x += acc.x * job->strength * job->bodies[i].stepDt;
+        job->velocities[i].y += acc.y * job->strength * job->bodies[i].stepDt;
+    }
+}
+
+// Zoom-adjusted screen bounds, or the fixed world if there is one
+static AABB SimulationArena(const GameState *state) {
+    if (state->worldWidth > 0 && state->worldHeight > 0) {
+        return (AABB){0, 0, state->worldWidth, state->worldHeight};
+    }
+
+    const Vector2 screenCenter = {state->screenWidth / 2.0f, state->screenHeight / 2.0f};
+    const float zoom = state->zoom;
+    return (AABB){
+        screenCenter.x - screenCenter.x / zoom, screenCenter.y - screenCenter.y / zoom,
+        screenCenter.x + screenCenter.x / zoom, screenCenter.y + screenCenter.y / zoom
+    };
+}
+
+void GlobalPositionUpdateSystem(ecs_iter_t *it) {
+    PROFILE_ZONE("GlobalPositionUpdateSystem");
+    GameState *state = ecs_singleton_get_mut(it->world, GameState);
+    const float dt = it->delta_time;
+
+    // Collect all entities from all tables, in flecs storage order
+    const int gatherCapacity = ecs_query_count(g_bodyQuery).entities;
+    g_bodies.gathered = frame_scratch_alloc(sizeof(BodyRef) * (gatherCapacity ? gatherCapacity : 1));
+    ReserveBodies(gatherCapacity);
+
+    int entityCount = 0;
+    int tableCount = 0;
+    ecs_iter_t query_it = ecs_query_iter(it->world, g_bodyQuery);
+    while (ecs_query_next(&query_it)) {
+        tableCount++;
+        Renderable *r = ecs_field(&query_it, Renderable, 0);
+        Velocity *v = ecs_field(&query_it, Velocity, 1);
+        Sleep *sl = ecs_field_is_set(&query_it, 2) ? ecs_field(&query_it, Sleep, 2) : NULL;
+        const bool isEnemy = ecs_field_is_set(&query_it, 3);
+
+        for (int i = 0; i < query_it.count && entityCount < gatherCapacity; i++) {
+            g_bodies.gathered[entityCount] = (BodyRef){
+                .entity = query_it.entities[i],
+                .renderable = &r[i],
+                .velocity = &v[i],
+                .sleep = sl ? &sl[i] : NULL,
+                .isEnemy = isEnemy
+            };
+            entityCount++;
+        }
+    }
+
+    const AABB arena = SimulationArena(state);
+    const float worldMinX = arena.x_min;
+    const float worldMaxX = arena.x_max;
+    const float worldMinY = arena.y_min;
+    const float worldMaxY = arena.y_max;
+
+    // Physics runs over copies laid out along a Morton curve, so neighbours in space
+    // are mostly neighbours in memory. Storage order follows spawn order instead.
+    if (SortBodiesIfDisordered(entityCount, arena)) {
+        state->spatialSorts++;
+    }
+
+    BodyRef *bodies = g_bodies.ref;
+    Vector2 *positions = g_bodies.position;
+    Vector2 *velocities = g_bodies.velocity;
+    float *radii = g_bodies.radius;
+
+    // Simulation LOD: bodies in band n from the player advance every 2^n ticks by
+    // 2^n * dt. Each body's turn is offset by its id so the work spreads across ticks.
+    const ecs_entity_t player = ecs_lookup(it->world, "Player");
+    const Renderable *playerRenderable = player ? ecs_get(it->world, player, Renderable) : NULL;
+    const unsigned int tick = state->physicsTick++;
+    for (int lod = 0; lod < SIM_LOD_COUNT; lod++) {
+        state->lodBodies[lod] = 0;
+    }
+
+    float maxStep = 0.0f; // Largest distance any body integrates this tick
+    for (int i = 0; i < entityCount; i++) {
+        bodies[i] = g_bodies.gathered[g_bodies.order[i]];
+        positions[i] = bodies[i].renderable->position;
+        velocities[i] = bodies[i].velocity->velocity;
+        radii[i] = bodies[i].renderable->radius;
+
+        SimLod lod = SIM_LOD_NEAR;
+        if (playerRenderable) {
+            const float distance = Vector2Distance(positions[i], playerRenderable->position);
+            while (lod + 1 < SIM_LOD_COUNT && state->lodDistances[lod] > 0 &&
+                   distance > state->lodDistances[lod]) {
+                lod++;
+            }
+        }
+
+        const unsigned int stride = 1u << lod;
+        bodies[i].lod = lod;
+        bodies[i].stepDt = ((tick + (unsigned int) bodies[i].entity) & (stride - 1)) == 0 ? dt * stride : 0.0f;
+        state->lodBodies[lod]++;
+
+        maxStep = fmaxf(maxStep, Vector2Length(velocities[i]) * bodies[i].stepDt);
+    }
+
+    // Bodies only rest in the modes without mutual forces
+    const bool canSleep = state->physics == REPEL || state->physics == ATTRACT;
+
+    // Neighbor lists cover every pair within both radii plus the margin.
+    // Without a skin they are rebuilt every tick and the margin only covers both
+    // bodies of a pair moving during this tick. With a skin they are Verlet lists,
+    // kept until some body drifts by half the skin or the set of bodies changes.
+    const float skin = state->neighborSkin;
+    const bool verlet = skin > 0.0f;
+    const float neighborMargin = (verlet ? skin : 2.0f * maxStep) +
+                                 (state->physics == FLOCK ? FLOCK_RADIUS : 0.0f);
+
+    bool rebuildNeighbors = !verlet || entityCount != g_neighbors.row_count ||
+                            neighborMargin != g_neighbors.margin;
+    for (int i = 0; i < entityCount && !rebuildNeighbors; i++) {
+        // Body order changes whenever bodies spawn, die, change archetype or
+        // get re-sorted
+        if (g_neighborEntities[i] != bodies[i].entity) {
+            rebuildNeighbors = true;
+            break;
+        }
+
+        // Include this tick's own step, which happens before its pairs are checked
+        const float drift = neighbor_list_drift(&g_neighbors, i, positions[i],
+                                                radii[i]);
+        const float step = Vector2Length(velocities[i]) * bodies[i].stepDt;
+        rebuildNeighbors = drift + step > skin * 0.5f;
+    }
+
+    // A tree built in the background from last tick's final positions replaces
+    // the current one if it covers the same bodies in the same order
+    WaitBackgroundQuadtree();
+    bool treeSwapped = false;
+    if (g_treeBack.count > 0 && QuadtreeBuildMatches(&g_treeBack, arena, bodies, entityCount)) {
+        const QuadtreeBuild front = g_treeFront;
+        g_treeFront = g_treeBack;
+        g_treeBack = front;
+        g_quadtree = g_treeFront.tree;
+        g_quadtreeBodyCount = entityCount;
+        state->quadtreeSwaps++;
+        treeSwapped = true;
+    }
+    g_treeBack.count = 0; // Used or stale; either way the storage is free for the next build
+
+    // Rebuild quadtree for broad-phase collision detection. With reused
+    // neighbor lists only NBODY still needs it this tick.
+    // Quadtree bounds match the zoom-adjusted world space
+    if ((rebuildNeighbors || state->physics == NBODY || g_quadtree == NULL) && !treeSwapped) {
+        PROFILE_ZONE("QuadtreeBuild");
+        CaptureQuadtreeBodies(&g_treeFront, arena, bodies, positions, radii, entityCount);
+        BuildQuadtree(&g_treeFront);
+        g_quadtree = g_treeFront.tree;
+        g_quadtreeBodyCount = entityCount;
+    }
+
+    // Queries pad by how far bodies moved or grew since the tree was built
+    // (nothing, unless it was built last tick or kept from an earlier one)
+    float treeDrift = 0.0f;
+    for (int i = 0; i < entityCount && i < g_treeFront.count; i++) {
+        const float moved = Vector2Distance(positions[i], g_treeFront.position[i]);
+        treeDrift = fmaxf(treeDrift, moved + fmaxf(radii[i] - g_treeFront.radius[i], 0.0f));
+    }
+
+    // Build every body's neighbor list once; collision and flocking both read it.
+    // Rows of resting bodies are skipped per tick, but Verlet lists must be complete.
+    if (rebuildNeighbors) {
+        PROFILE_ZONE("NeighborListBuild");
+        if (entityCount > g_neighborEntityCapacity) {
+            g_neighborEntities = memtrack_realloc(MEMTRACK_NEIGHBORS, g_neighborEntities, sizeof(ecs_entity_t) * entityCount);
+            g_neighborEntityCapacity = entityCount;
+        }
+
+        neighbor_list_begin(&g_neighbors, entityCount, neighborMargin);
+        for (int i = 0; i < entityCount; i++) {
+            g_neighborEntities[i] = bodies[i].entity;
+
+            const Sleep *sleep = bodies[i].sleep;
+            if (verlet || !(canSleep && sleep && sleep->asleep)) {
+                neighbor_list_append_padded(&g_neighbors, g_quadtree, i, positions[i],
+                                            radii[i], treeDrift);
+            } else {
+                neighbor_list_append_empty(&g_neighbors, i);
+            }
+        }
+        state->neighborRebuilds++;
+    }
+
+    for (int i = 0; i < entityCount; i++) {
+        const Sleep *sleep = bodies[i].sleep;
+        bodies[i].hasNeighbors = verlet || !(canSleep && sleep && sleep->asleep);
+    }
+
+    if (state->physics == FLOCK) {
+        const float SEPARATION_RADIUS = 10.0f; // Gap (px) below which flockmates push apart
+        const float SEPARATION_WEIGHT = 300.0f;
+        const float ALIGNMENT_WEIGHT = 1.5f;
+        const float COHESION_WEIGHT = 0.8f;
+        const float FLOCK_MAX_SPEED = 150.0f;
+
+        for (int i = 0; i < entityCount; i++) {
+            // Steering is a near-field detail; reduced-rate bodies just coast
+            if (!bodies[i].isEnemy || bodies[i].lod != SIM_LOD_NEAR) continue;
+
+            const Vector2 p = positions[i];
+            const float r = radii[i];
+            Vector2 separation = {0, 0};
+            Vector2 heading = {0, 0};
+            Vector2 center = {0, 0};
+            int flockmates = 0;
+
+            const int *row = neighbor_list_row(&g_neighbors, i);
+            const int rowCount = neighbor_list_count(&g_neighbors, i);
+            for (int k = 0; k < rowCount; k++) {
+                const int j = row[k];
+                if (!bodies[j].isEnemy) continue;
+
+                const Vector2 d = Vector2Subtract(positions[j], p);
+                const float distance = Vector2Length(d);
+                const float gap = distance - r - radii[j];
+                if (gap > FLOCK_RADIUS) continue;
+
+                flockmates++;
+                heading = Vector2Add(heading, velocities[j]);
+                center = Vector2Add(center, positions[j]);
+
+                if (gap < SEPARATION_RADIUS && distance > 0) {
+                    const float push = 1.0f - fmaxf(gap, 0.0f) / SEPARATION_RADIUS;
+                    separation = Vector2Subtract(separation, Vector2Scale(d, push / distance));
+                }
+            }
+
+            if (flockmates == 0) continue;
+
+            Vector2 *v = &velocities[i];
+            heading = Vector2Scale(heading, 1.0f / flockmates);
+            center = Vector2Scale(center, 1.0f / flockmates);
+
+            Vector2 steer = Vector2Scale(separation, SEPARATION_WEIGHT);
+            steer = Vector2Add(steer, Vector2Scale(Vector2Subtract(heading, *v), ALIGNMENT_WEIGHT));
+            steer = Vector2Add(steer, Vector2Scale(Vector2Subtract(center, p), COHESION_WEIGHT));
+            *v = Vector2Add(*v, Vector2Scale(steer, dt));
+
+            const float speed = Vector2Length(*v);
+            if (speed > FLOCK_MAX_SPEED) {
+                *v = Vector2Scale(*v, FLOCK_MAX_SPEED / speed);
+            }
+        }
+    }
+
+    if (state->physics == NBODY) {
+        // Barnes-Hut: aggregate mass bottom-up, then every enemy sums far cells as point masses
+        PROFILE_BEGIN("QuadtreeComputeMass");
+        quadtree_compute_mass(g_quadtree);
+        PROFILE_END();
+
+        // Tree walks dominate NBODY and are independent per body: fan them out
+        const int GRAVITY_MIN_CHUNK = 64;
+        GravityJob job = {
+            .bodies = bodies,
+            .positions = positions,
+            .velocities = velocities,
+            .openingAngle = state->openingAngle,
+            .strength = state->nbodyStrength
+        };
+        jobs_parallel_for(entityCount, GRAVITY_MIN_CHUNK, GravityRange, &job);
+    }
+
+    int sleepingCount = 0;
+    const float restitution = 0.9f; // Bounciness: 0 = no bounce, 1 = perfect bounce
+    // ATTRACT resolves separating pairs instead of approaching ones
+    const float resolveSide = state->physics == ATTRACT ? -1.0f : 1.0f;
+
+    contact_table_begin_frame(&g_contacts);
+
+    // Update positions and handle collisions across all tables
+    for (int i = 0; i < entityCount; i++) {
+        Sleep *sleep_i = bodies[i].sleep;
+
+        if (sleep_i && sleep_i->asleep) {
+            const Vector2 p = positions[i];
+            const float r = radii[i];
+
+            // The arena follows the zoom, so a resting body can end up outside it.
+            // In NBODY and FLOCK modes every body feels a force, so nothing may rest.
+            if (canSleep &&
+                p.x >= worldMinX + r && p.x <= worldMaxX - r &&
+                p.y >= worldMinY + r && p.y <= worldMaxY - r) {
+                // Skipped: no integration, and its pairs are handled by awake neighbours.
+                // Contacts with other sleepers stay as they were.
+                contact_table_hold(&g_contacts, bodies[i].entity);
+                sleepingCount++;
+                continue;
+            }
+            WakeBody(sleep_i);
+        }
+
+        // Not this body's turn: like a sleeper, its pairs are handled by active
+        // neighbours, and contacts with other skipped bodies stay as they were
+        const float stepDt = bodies[i].stepDt;
+        if (stepDt == 0) {
+            contact_table_hold(&g_contacts, bodies[i].entity);
+            continue;
+        }
+
+        positions[i].x += velocities[i].x * stepDt;
+        positions[i].y += velocities[i].y * stepDt;
+
+        // Nearby entities from this tick's neighbor list (broad-phase)
+        const int *nearby_indices = neighbor_list_row(&g_neighbors, i);
+        int nearby_count = neighbor_list_count(&g_neighbors, i);
+
+        int woken_indices[256];
+        if (!bodies[i].hasNeighbors) {
+            // Woken during this tick after the lists were built: query directly
+            AABB query_bounds = aabb_from_circle(
+                positions[i],
+                radii[i] + neighborMargin + treeDrift
+            );
+            nearby_count = quadtree_query(g_quadtree, query_bounds, woken_indices, 256);
+            nearby_indices = woken_indices;
+        }
+
+        // Check collisions only with nearby entities (narrow-phase)
+        for (int k = 0; k < nearby_count; k++) {
+            int j = nearby_indices[k];
+
+            // Skip self and already-checked pairs. Sleeping bodies and bodies skipped
+            // by LOD never check their own pairs, so an active body must also handle
+            // those before it.
+            Sleep *sleep_j = bodies[j].sleep;
+            const bool j_asleep = sleep_j && sleep_j->asleep;
+            if (j == i || (j < i && !j_asleep && bodies[j].stepDt > 0)) continue;
+
+            Vector2 dir = {
+                .x = positions[j].x - positions[i].x,
+                .y = positions[j].y - positions[i].y
+            };
+
+            const float magnitude = sqrtf(dir.x * dir.x + dir.y * dir.y);
+            const float boundary = radii[j] + radii[i];
+            if (magnitude > boundary) {
+                continue;
+            }
+
+            Contact *contact = contact_table_touch(&g_contacts, bodies[i].entity, bodies[j].entity);
+            if (contact && magnitude > 0) {
+                contact->impact_speed = fabsf(
+                    ((velocities[j].x - velocities[i].x) * dir.x +
+                     (velocities[j].y - velocities[i].y) * dir.y) / magnitude);
+            }
+
+            // Check for Spike
+            const Spike *spike_i = ecs_get(it->world, bodies[i].entity, Spike);
+            const Spike *spike_j = ecs_get(it->world, bodies[j].entity, Spike);
+            const Mortal *mortal_i = ecs_get(it->world, bodies[i].entity, Mortal);
+            const Mortal *mortal_j = ecs_get(it->world, bodies[j].entity, Mortal);
+
+            // Destroy both
+            if (spike_i && mortal_i && spike_j && mortal_j) {
+                TriggerDestruction(it->world, bodies[i].entity);
+                TriggerDestruction(it->world, bodies[j].entity);
+                continue;
+            }
+
+            if (spike_i && mortal_j) {
+                TriggerDestruction(it->world, bodies[j].entity);
+                continue;
+            }
+
+            if (spike_j && mortal_i) {
+                TriggerDestruction(it->world, bodies[i].entity);
+                continue;
+            }
+
+            // Normalize direction
+            if (magnitude > 0) {
+                dir.x /= magnitude;
+                dir.y /= magnitude;
+            }
+
+            if (j_asleep) {
+                if (Vector2Length(velocities[i]) > SLEEP_VELOCITY_THRESHOLD) {
+                    WakeBody(sleep_j);
+                } else {
+                    // A slow contact doesn't disturb a resting body: treat it as static
+                    // and resolve the full overlap and impulse on the awake body alone
+                    positions[i].x -= dir.x * (boundary - magnitude);
+                    positions[i].y -= dir.y * (boundary - magnitude);
+
+                    float velocityAlongNormal = -(velocities[i].x * dir.x +
+                                                  velocities[i].y * dir.y);
+                    if (resolveSide * velocityAlongNormal < 0) {
+                        float impulseMagnitude = -(1 + restitution) * velocityAlongNormal;
+                        velocities[i].x -= dir.x * impulseMagnitude;
+                        velocities[i].y -= dir.y * impulseMagnitude;
+                    }
+                    continue;
+                }
+            }
+
+            // Adjust positions
+            const float adjustment = (boundary - magnitude) * 0.5f;
+            positions[i].x -= dir.x * adjustment;
+            positions[i].y -= dir.y * adjustment;
+            positions[j].x += dir.x * adjustment;
+            positions[j].y += dir.y * adjustment;
+
+            // Adjust velocity
+            // Calculate relative velocity
+            Vector2 relativeVelocity = {
+                velocities[j].x - velocities[i].x,
+                velocities[j].y - velocities[i].y
+            };
+
+            // Calculate velocity along the collision normal (dir)
+            const float velocityAlongNormal = relativeVelocity.x * dir.x + relativeVelocity.y * dir.y;
+
+            // Bounce only if entities are moving toward each other, otherwise leave them be
+            const float targetAlongNormal = resolveSide * velocityAlongNormal < 0
+                                                ? -restitution * velocityAlongNormal
+                                                : velocityAlongNormal;
+
+            // Both entities have equal "mass", so each takes half of the velocity change
+            float totalImpulse = (targetAlongNormal - velocityAlongNormal) * 0.5f;
+            if (resolveSide * totalImpulse < 0) totalImpulse = 0;
+
+            // Apply impulse to both entities
+            velocities[i].x -= dir.x * totalImpulse;
+            velocities[i].y -= dir.y * totalImpulse;
+
+            velocities[j].x += dir.x * totalImpulse;
+            velocities[j].y += dir.y * totalImpulse;
+        }
+
+        // World boundary collision (zoom-adjusted)
+        if (positions[i].x < worldMinX + radii[i] ||
+            positions[i].x > worldMaxX - radii[i]) {
+            velocities[i].x *= -1;
+            positions[i].x = CLAMP(positions[i].x,
+                                                       worldMinX + radii[i],
+                                                       worldMaxX - radii[i]);
+            PlayBounceSoundWithVelocity(velocities[i].x);
+        }
+
+        if (positions[i].y < worldMinY + radii[i] ||
+            positions[i].y > worldMaxY - radii[i]) {
+            velocities[i].y *= -1;
+            positions[i].y = CLAMP(positions[i].y,
+                                                       worldMinY + radii[i],
+                                                       worldMaxY - radii[i]);
+            PlayBounceSoundWithVelocity(velocities[i].y);
+        }
+
+        // Fall asleep after resting below the threshold long enough
+        if (sleep_i && canSleep) {
+            if (Vector2Length(velocities[i]) < SLEEP_VELOCITY_THRESHOLD) {
+                sleep_i->restTime += stepDt;
+                if (sleep_i->restTime >= SLEEP_TIME) {
+                    sleep_i->asleep = true;
+                    velocities[i] = (Vector2){0, 0};
+                }
+            } else {
+                sleep_i->restTime = 0;
+            }
+        }
+    }
+
+    state->sleepingBodies = sleepingCount;
+
+    // Write the results back to flecs storage
+    float slack = 0.0f;
+    float maxRadius = 0.0f;
+    for (int i = 0; i < entityCount; i++) {
+        bodies[i].renderable->position = positions[i];
+        bodies[i].velocity->velocity = velocities[i];
+        if (i < g_treeFront.count) {
+            slack = fmaxf(slack, Vector2Distance(positions[i], g_treeFront.position[i]));
+        }
+        maxRadius = fmaxf(maxRadius, radii[i]);
+    }
+    // Radii can still grow this tick (spawn springs); twice the largest covers it
+    g_quadtreeSlack = slack + 2.0f * maxRadius;
+
+    // Next tick's tree, built off the critical path from where the bodies are now
+    if (state->backgroundQuadtree && entityCount > 0) {
+        CaptureQuadtreeBodies(&g_treeBack, arena, bodies, positions, radii, entityCount);
+        jobs_submit(BuildQuadtreeJob, &g_treeBack, &g_treeBackDone);
+        g_treeBackPending = true;
+    }
+
+    // Publish this tick's contact events; the loudest new impact drives the bounce sound
+    contact_table_end_frame(&g_contacts);
+
+    const float IMPACT_SOUND_THRESHOLD = 50.0f;
+    float loudestImpact = 0.0f;
+    for (int e = 0; e < g_contacts.event_count; e++) {
+        const ContactEvent *event = &g_contacts.events[e];
+        if (event->type == CONTACT_ENTER) {
+            loudestImpact = fmaxf(loudestImpact, event->impact_speed);
+        }
+    }
+    if (loudestImpact > IMPACT_SOUND_THRESHOLD) {
+        PlayBounceSoundWithVelocity(loudestImpact);
+    }
+}
+
+// Steps every running radius spring and copies the results into Renderable.radius.
+// Only animating bodies are visited; finished springs just leave their handles stale.
+void RadiusTweenSystem(ecs_iter_t *it) {
+    PROFILE_ZONE("RadiusTweenSystem");
+    tween_update(&g_tweens, it->delta_time);
+
+    for (int i = 0; i < g_tweens.count; i++) {
+        const ecs_entity_t owner = g_tweens.owner[i];
+        Renderable *r = ecs_is_alive(it->world, owner) ? ecs_get_mut(it->world, owner, Renderable) : NULL;
+        if (r) r->radius = g_tweens.value[i];
+    }
+
+    for (int f = 0; f < g_tweens.finished_count; f++) {
+        const TweenFinished *finished = &g_tweens.finished[f];
+        Renderable *r = ecs_is_alive(it->world, finished->owner)
+                            ? ecs_get_mut(it->world, finished->owner, Renderable)
+                            : NULL;
+        if (!r) continue;
+
+        r->radius = finished->value;
+        if (finished->value <= 0.0f) {
+            ecs_delete(it->world, finished->owner);
+        }
+    }
+}
+
+// Keeps the camera on the player in a fixed world and streams sectors around it.
+// Runs after the physics step so bodies are frozen where they came to rest.
+void SectorStreamingSystem(ecs_iter_t *it) {
+    PROFILE_ZONE("SectorStreamingSystem");
+    GameState *state = ecs_singleton_get_mut(it->world, GameState);
+
+    if (state->worldWidth <= 0 || state->worldHeight <= 0) {
+        state->camera = (Vector2){state->screenWidth / 2.0f, state->screenHeight / 2.0f};
+        return;
+    }
+
+    const ecs_entity_t player = ecs_lookup(it->world, "Player");
+    const Renderable *playerRenderable = player ? ecs_get(it->world, player, Renderable) : NULL;
+    if (playerRenderable) {
+        state->camera = playerRenderable->position;
+    }
+
+    SectorsUpdate(it->world, state->camera);
+    state->activeSectors = g_sectors.activeSectors;
+    state->frozenBodies = g_sectors.frozenBodies;
+}
+
+static void RegisterSystem(const char *name, ecs_entity_t entity) {
+    if (g_game_system_count < GAME_MAX_SYSTEMS) {
+        g_game_systems[g_game_system_count++] = (GameSystem){name, entity};
+    }
+}
+
+// Tagged allocation hooks for flecs and the quadtree
+static void *FlecsMalloc(ecs_size_t size) {
+    return memtrack_alloc(MEMTRACK_FLECS, (size_t) size);
+}
+
+static void *FlecsCalloc(ecs_size_t size) {
+    return memtrack_calloc(MEMTRACK_FLECS, 1, (size_t) size);
+}
+
+static void *FlecsRealloc(void *ptr, ecs_size_t size) {
+    return memtrack_realloc(MEMTRACK_FLECS, ptr, (size_t) size);
+}
+
+static void *SpatialAlloc(size_t size) {
+    return memtrack_alloc(MEMTRACK_SPATIAL, size);
+}
+
+void GameInstallMemoryTracking(void) {
+    ecs_os_set_api_defaults();
+    ecs_os_api_t api = ecs_os_api;
+    api.malloc_ = FlecsMalloc;
+    api.calloc_ = FlecsCalloc;
+    api.realloc_ = FlecsRealloc;
+    api.free_ = memtrack_free;
+    ecs_os_set_api(&api);
+
+    spatial_set_allocator(SpatialAlloc, memtrack_free);
+}
+
+void GameInit(ecs_world_t *world, int screenWidth, int screenHeight, unsigned int seed) {
+    ECS_COMPONENT_DEFINE(world, Health);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_COMPONENT_DEFINE(world, PlayerInput);
+    ECS_COMPONENT_DEFINE(world, EnemyInput);
+    ECS_COMPONENT_DEFINE(world, Renderable);
+    ECS_COMPONENT_DEFINE(world, RadiusTween);
+    ECS_COMPONENT_DEFINE(world, AttractionRangeVFX);
+    ECS_COMPONENT_DEFINE(world, Spike);
+    ECS_COMPONENT_DEFINE(world, Mortal);
+    ECS_COMPONENT_DEFINE(world, Sleep);
+    ECS_COMPONENT_DEFINE(world, GameState);
+
+    ecs_singleton_set(world, GameState, {
+                      .physics = REPEL,
+                      .zoom = 1.0f,
+                      .targetZoom = 1.0f,
+                      .screenWidth = screenWidth,
+                      .screenHeight = screenHeight,
+                      .input = 0,
+                      .randomState = seed ? seed : 1, // xorshift state must be non-zero
+                      .nbodyStrength = 4000.0f,
+                      .openingAngle = 0.5f,
+                      .neighborSkin = 15.0f,
+                      .camera = {screenWidth / 2.0f, screenHeight / 2.0f}
+                      });
+
+    // Instances get their own copy of each component (flecs' default OnInstantiate
+    // policy), so systems still write them per enemy. Renderable stays off the
+    // prefab: every enemy brings its own position, and snapshot restores delete
+    // everything with a Renderable.
+    g_enemyPrefab = ecs_entity(world, {.name = "Enemy", .add = ecs_ids(EcsPrefab)});
+    ecs_set(world, g_enemyPrefab, Health, {.health = 100});
+    ecs_set(world, g_enemyPrefab, Velocity, {.velocity = {0, 0}});
+    ecs_set(world, g_enemyPrefab, EnemyInput, {.directionSet = false});
+    ecs_set(world, g_enemyPrefab, RadiusTween, {.handle = 0});
+    ecs_set(world, g_enemyPrefab, Mortal, {});
+    ecs_set(world, g_enemyPrefab, Sleep, {.restTime = 0, .asleep = false});
+
+    // Queries created mid-run would take entity ids from the run (SpawnPlayer)
+    SnapshotInit(world);
+
+    g_spawnSpring = tween_profile(&g_tweens, SPAWN_SPRING_STIFFNESS, SPAWN_SPRING_DAMPING);
+    g_destructionSpring = tween_profile(&g_tweens, DESTRUCTION_SPRING_STIFFNESS, DESTRUCTION_SPRING_DAMPING);
+
+    g_bodyQuery = ecs_query(world, {
+       .terms = {
+       { ecs_id(Renderable) }, { ecs_id(Velocity) },
+       { ecs_id(Sleep), .oper = EcsOptional },
+       { ecs_id(EnemyInput), .oper = EcsOptional },
+       },
+       .cache_kind = EcsQueryCacheAuto
+    });
+    g_hashQuery = ecs_query(world, {
+       .terms = {
+       { ecs_id(Renderable) }, { ecs_id(Velocity) },
+       },
+       .cache_kind = EcsQueryCacheAuto
+    });
+
+    ECS_SYSTEM(world, PlayerMovementSystem, EcsOnUpdate, Velocity, PlayerInput);
+    ECS_SYSTEM(world, EnemyMovementSystem, EcsOnUpdate, Velocity, EnemyInput, Renderable, ?Sleep);
+    ECS_SYSTEM(world, GlobalPositionUpdateSystem, EcsOnUpdate);
+    ECS_SYSTEM(world, RadiusTweenSystem, EcsOnUpdate);
+    ECS_SYSTEM(world, SectorStreamingSystem, EcsOnUpdate);
+
+    g_game_system_count = 0;
+    RegisterSystem("PlayerMovementSystem", PlayerMovementSystem);
+    RegisterSystem("EnemyMovementSystem", EnemyMovementSystem);
+    RegisterSystem("GlobalPositionUpdateSystem", GlobalPositionUpdateSystem);
+    RegisterSystem("RadiusTweenSystem", RadiusTweenSystem);
+    RegisterSystem("SectorStreamingSystem", SectorStreamingSystem);
+}
+
+void GameSetWorldSize(ecs_world_t *world, float width, float height) {
+    GameState *state = ecs_singleton_get_mut(world, GameState);
+    state->worldWidth = width;
+    state->worldHeight = height;
+    state->camera = (Vector2){width / 2.0f, height / 2.0f};
+    // A fixed world is larger than the screen: bodies far from the player step less often
+    state->lodDistances[0] = LOD_MID_DISTANCE;
+    state->lodDistances[1] = LOD_FAR_DISTANCE;
+    SectorsInit(world, width, height);
+}
+
+void GameShutdown(void) {
+    // Cleanup spatial partitioning
+    WaitBackgroundQuadtree();
+    FreeQuadtreeBuild(&g_treeFront);
+    FreeQuadtreeBuild(&g_treeBack);
+    g_quadtree = NULL;
+    g_quadtreeBodyCount = 0;
+    neighbor_list_free(&g_neighbors);
+    contact_table_free(&g_contacts);
+    FreeBodies();
+    SectorsShutdown();
+    SnapshotShutdown();
+    tween_pool_free(&g_tweens);
+    frame_scratch_free();
+    if (g_bodyQuery) {
+        ecs_query_fini(g_bodyQuery);
+        g_bodyQuery = NULL;
+    }
+    if (g_hashQuery) {
+        ecs_query_fini(g_hashQuery);
+        g_hashQuery = NULL;
+    }
+    memtrack_free(g_neighborEntities);
+    g_neighborEntities = NULL;
+    g_neighborEntityCapacity = 0;
+}
+
+void GameRestored(ecs_world_t *world) {
+    // Nothing cached from before the restore describes the restored bodies
+    WaitBackgroundQuadtree();
+    g_treeBack.count = 0;
+    g_bodies.orderCount = 0;
+    neighbor_list_begin(&g_neighbors, 0, 0.0f);
+    contact_table_clear(&g_contacts);
+
+    // Index the restored bodies right away, so they can be drawn before the next tick
+    const GameState *state = ecs_singleton_get(world, GameState);
+    int count = 0;
+    float maxRadius = 0.0f;
+    const int capacity = ecs_query_count(g_bodyQuery).entities;
+    ReserveQuadtreeBuild(&g_treeFront, capacity);
+    ecs_iter_t it = ecs_query_iter(world, g_bodyQuery);
+    while (ecs_query_next(&it)) {
+        const Renderable *r = ecs_field(&it, Renderable, 0);
+        const bool isEnemy = ecs_field_is_set(&it, 3);
+
+        for (int i = 0; i < it.count && count < capacity; i++) {
+            g_treeFront.entity[count] = it.entities[i];
+            g_treeFront.position[count] = r[i].position;
+            g_treeFront.radius[count] = r[i].radius;
+            g_treeFront.mass[count] = isEnemy ? 1.0f : 0.0f;
+            maxRadius = fmaxf(maxRadius, r[i].radius);
+            count++;
+        }
+    }
+
+    g_treeFront.arena = SimulationArena(state);
+    g_treeFront.count = count;
+    BuildQuadtree(&g_treeFront);
+    g_quadtree = g_treeFront.tree;
+    g_quadtreeBodyCount = count;
+    g_quadtreeSlack = 2.0f * maxRadius;
+}
+
+ecs_entity_t SpawnPlayer(ecs_world_t *world) {
+    const GameState *state = ecs_singleton_get(world, GameState);
+    ecs_set_entity_range(world, GAME_ENTITY_ID_START, 0);
+
+    ecs_entity_t player = ecs_new(world);
+    ecs_set_name(world, player, "Player"); // {}
+    ecs_set(world, player, Health, {.health = 100});
+    ecs_set(world, player, Renderable, {
+            .position = state->camera,
+            .radius = 20,
+            .colorIndex = COLOR_FOREGROUND
+            });
+    ecs_set(world, player, Velocity, {.velocity ={0, 0}});
+    ecs_set(world, player, PlayerInput, {});
+    ecs_set(world, player, AttractionRangeVFX, {
+            .range = (float)MIN(state->screenWidth, state->screenHeight) / 2,
+            // Match MAX_ATTRACTION_RANGE from EnemyMovementSystem
+            .currentRange = 0,
+            .targetRange = 0,
+            .velocity = 0,
+            .damping = 0.95f,
+            .stiffness = 0.01f,
+            .colorIndex = COLOR_PALETTE_4,
+            .active = true,
+            .wasActive = false
+            });
+    ecs_set(world, player, Spike, {});
+
+    return player;
+}
+
+const ecs_entity_t *SpawnEnemies(ecs_world_t *world, const Vector2 *positions, int count) {
+    if (count <= 0) return NULL;
+    PROFILE_ZONE("SpawnEnemies");
+
+    // Only the position differs per enemy; everything else comes from the prefab
+    Renderable *renderables = frame_scratch_alloc(sizeof(Renderable) * count);
+    if (!renderables) return NULL;
+    for (int i = 0; i < count; i++) {
+        renderables[i] = (Renderable){
+            .position = positions[i],
+            .radius = ENEMY_SPAWN_RADIUS,
+            .colorIndex = COLOR_PALETTE_2
+        };
+    }
+
+    void *data[] = {NULL, renderables};
+    const ecs_entity_t *enemies = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+                                                    .count = count,
+                                                    .ids = {ecs_pair(EcsIsA, g_enemyPrefab), ecs_id(Renderable)},
+                                                    .data = data
+                                                });
+
+    // Each enemy already has its RadiusTween from the prefab, so this stays in the table
+    for (int i = 0; i < count; i++) {
+        RadiusTween *tween = ecs_get_mut(world, enemies[i], RadiusTween);
+        tween->handle = tween_start(&g_tweens, g_spawnSpring, enemies[i], ENEMY_SPAWN_RADIUS, 0.0f, ENEMY_RADIUS);
+    }
+
+    PlayEnemySpawnSound();
+    return enemies;
+}
+
+void SpawnEnemy(ecs_world_t *world, Vector2 position) {
+    SpawnEnemies(world, &position, 1);
+}
+
+ecs_entity_t RestoreEnemy(ecs_world_t *world, Vector2 position, Vector2 velocity, float radius, float health) {
+    // Like SpawnEnemies, everything but the body's own state comes from the prefab.
+    // ecs_new_w_pair rather than ecs_bulk_init: sectors thaw inside a system,
+    // where only deferred operations are safe.
+    const ecs_entity_t enemy = ecs_new_w_pair(world, EcsIsA, g_enemyPrefab);
+
+    ecs_set(world, enemy, Renderable, {.position = position, .radius = radius,
+            .colorIndex = COLOR_PALETTE_2});
+    ecs_set(world, enemy, Velocity, {.velocity = velocity});
+    // Keep the frozen heading instead of picking a new random one
+    ecs_set(world, enemy, EnemyInput, {.directionSet = true});
+    if (health != 100) ecs_set(world, enemy, Health, {.health = health});
+
+    return enemy;
+}
+
+void GameApplyInput(ecs_world_t *world, const TickInput *input) {
+    GameState *state = ecs_singleton_get_mut(world, GameState);
+    state->prevInput = state->input;
+    state->input = input->buttons;
+    state->screenWidth = input->screenWidth;
+    state->screenHeight = input->screenHeight;
+
+    if (input->buttons & INPUT_CYCLE_PHYSICS) {
+        state->physics = (state->physics + 1) % PHYSICS_COUNT;
+    }
+
+    // Held spawns pile up and leave in batches; a tap still spawns right away
+    const bool spawnHeld = (input->buttons & INPUT_SPAWN) != 0;
+    const bool spawnPressed = spawnHeld && !(state->prevInput & INPUT_SPAWN);
+    if (spawnHeld) state->heldSpawns++;
+
+    int count = 0;
+    if (state->heldSpawns >= SPAWN_BATCH_TICKS || (state->heldSpawns > 0 && (spawnPressed || !spawnHeld))) {
+        count = state->heldSpawns;
+        state->heldSpawns = 0;
+    }
+    if (input->buttons & INPUT_SPAWN_WAVE) count += ENEMY_WAVE_SIZE;
+
+    // All of this tick's spawns go out as one batch
+    if (count > 0) {
+        // Spawn on screen: in a fixed world the screen is centered on the camera
+        Vector2 origin = {0, 0};
+        if (state->worldWidth > 0 && state->worldHeight > 0) {
+            origin = (Vector2){state->camera.x - input->screenWidth / 2.0f,
+                               state->camera.y - input->screenHeight / 2.0f};
+        }
+
+        Vector2 *positions = frame_scratch_alloc(sizeof(Vector2) * count);
+        if (!positions) return;
+        for (int i = 0; i < count; i++) {
+            positions[i] = (Vector2){
+                origin.x + (float) GameRandomValue(state, 50, input->screenWidth - 50),
+                origin.y + (float) GameRandomValue(state, 50, input->screenHeight - 50)
+            };
+        }
+        SpawnEnemies(world, positions, count);
+    }
+}
+
+void GameTick(ecs_world_t *world, const TickInput *input) {
+    GameApplyInput(world, input);
+    // ecs_progress measures wall-clock time when given 0, which would break replays
+    ecs_progress(world, input->dt > 0 ? input->dt : 1.0f / 60.0f);
+    frame_scratch_swap();
+}
+
+typedef struct {
+    ecs_entity_t *entities;
+    int count;
+    BodyCluster *clusters;
+    int clusterCount;
+} VisibleQuery;
+
+static void CollectVisible(int index, void *user_data) {
+    VisibleQuery *query = user_data;
+    query->entities[query->count++] = g_treeFront.entity[index];
+}
+
+static void CollectCluster(Vector2 centroid, float radius, int count, int first_index, void *user_data) {
+    VisibleQuery *query = user_data;
+    query->clusters[query->clusterCount++] = (BodyCluster){
+        .center = centroid,
+        .radius = radius,
+        .count = count,
+        .entity = g_treeFront.entity[first_index]
+    };
+}
+
+int GameQueryVisible(AABB view, float clusterSize, const ecs_entity_t **entities,
+                     const BodyCluster **clusters, int *clusterCount) {
+    *entities = NULL;
+    *clusters = NULL;
+    *clusterCount = 0;
+    if (g_quadtree == NULL || g_quadtreeBodyCount == 0) return 0;
+
+    const AABB padded = {
+        view.x_min - g_quadtreeSlack, view.y_min - g_quadtreeSlack,
+        view.x_max + g_quadtreeSlack, view.y_max + g_quadtreeSlack
+    };
+    // Each body is reported once, alone or in a cluster of at least two
+    VisibleQuery query = {
+        .entities = frame_scratch_alloc(sizeof(ecs_entity_t) * g_quadtreeBodyCount),
+        .clusters = frame_scratch_alloc(sizeof(BodyCluster) * (g_quadtreeBodyCount / 2 + 1))
+    };
+    quadtree_query_clustered(g_quadtree, padded, clusterSize, CollectVisible, CollectCluster, &query);
+
+    *entities = query.entities;
+    *clusters = query.clusters;
+    *clusterCount = query.clusterCount;
+    return query.count;
+}
+
+int GameRandomValue(GameState *state, int min, int max) {
+    if (min > max) {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+
+    // xorshift32
+    unsigned int x = state->randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->randomState = x;
+
+    return min + (int) (x % (unsigned int) (max - min + 1));
+}
+
+// FNV-1a over raw bytes
+static unsigned int HashBytes(unsigned int hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+unsigned int GameStateHash(ecs_world_t *world) {
+    unsigned int hash = 2166136261u;
+
+    const GameState *state = ecs_singleton_get(world, GameState);
+    hash = HashBytes(hash, &state->physics, sizeof(state->physics));
+    hash = HashBytes(hash, &state->zoom, sizeof(state->zoom));
+    hash = HashBytes(hash, &state->randomState, sizeof(state->randomState));
+
+    // Ids relative to the player's, so only the order of creation during the run counts
+    const uint32_t player = (uint32_t) ecs_lookup(world, "Player");
+    ecs_iter_t it = ecs_query_iter(world, g_hashQuery);
+    while (ecs_query_next(&it)) {
+        const Renderable *r = ecs_field(&it, Renderable, 0);
+        const Velocity *v = ecs_field(&it, Velocity, 1);
+
+        for (int i = 0; i < it.count; i++) {
+            const uint32_t id = (uint32_t) it.entities[i] - player;
+            hash = HashBytes(hash, &id, sizeof(id));
+            hash = HashBytes(hash, &r[i].position, sizeof(Vector2));
+            hash = HashBytes(hash, &r[i].radius, sizeof(float));
+            hash = HashBytes(hash, &v[i].velocity, sizeof(Vector2));
+        }
+    }
+
+    // Enemies in dormant sectors are simulated state too, just not entities
+    for (int s = 0; s < g_sectors.columns * g_sectors.rows; s++) {
+        const Sector *sector = &g_sectors.sectors[s];
+        hash = HashBytes(hash, sector->bodies, sizeof(FrozenBody) * sector->count);
+    }
+    return hash;
+}
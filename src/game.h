@@ -0,0 +1,291 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdbool.h>
+#include <flecs.h>
+#include <raylib.h>
+#include "spatial.h"
+#include "contacts.h"
+#include "tween.h"
+#include "tick_input.h"
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define CLAMP(x, min, max) ((x) < (min) ? (min) : ((x) > (max) ? (max) : (x)))
+
+// Spatial index rebuilt by the simulation every tick
+extern Quadtree *g_quadtree;
+
+// Springs animating body radii (RadiusTween)
+extern TweenPool g_tweens;
+
+typedef enum {
+    COLOR_PALETTE_0,
+    COLOR_PALETTE_1,
+    COLOR_PALETTE_2,
+    COLOR_PALETTE_3,
+    COLOR_PALETTE_4,
+    COLOR_PALETTE_5,
+    COLOR_PALETTE_6,
+    COLOR_PALETTE_7,
+    COLOR_PALETTE_8,
+    COLOR_PALETTE_9,
+    COLOR_PALETTE_10,
+    COLOR_PALETTE_11,
+    COLOR_PALETTE_12,
+    COLOR_PALETTE_13,
+    COLOR_PALETTE_14,
+    COLOR_PALETTE_15,
+    COLOR_BACKGROUND,
+    COLOR_FOREGROUND,
+    COLOR_CURSOR,
+    COLOR_SELECTION
+} ThemeColor;
+
+// ECS
+typedef struct {
+    float health;
+} Health;
+
+extern ECS_COMPONENT_DECLARE(Health);
+
+typedef struct {
+    Vector2 velocity;
+} Velocity;
+
+extern ECS_COMPONENT_DECLARE(Velocity);
+
+typedef struct {
+    bool defaultValue;
+} PlayerInput;
+
+extern ECS_COMPONENT_DECLARE(PlayerInput);
+
+typedef struct {
+    bool directionSet;
+} EnemyInput;
+
+extern ECS_COMPONENT_DECLARE(EnemyInput);
+
+typedef struct {
+    Vector2 position;
+    float radius;
+    ThemeColor colorIndex;
+} Renderable;
+
+extern ECS_COMPONENT_DECLARE(Renderable);
+
+// Handle of the spring in g_tweens animating Renderable.radius, 0 or stale when at
+// rest. Every enemy has one from spawn on, so animations starting and ending never
+// move an entity to another table.
+typedef struct {
+    TweenHandle handle;
+} RadiusTween;
+
+extern ECS_COMPONENT_DECLARE(RadiusTween);
+
+typedef struct {
+    float range;
+    float currentRange;
+    float targetRange;
+    float velocity;
+    float damping;
+    float stiffness;
+    ThemeColor colorIndex;
+    bool active;
+    bool wasActive;
+} AttractionRangeVFX;
+
+extern ECS_COMPONENT_DECLARE(AttractionRangeVFX);
+
+typedef struct {
+    bool unused;
+} Spike;
+
+extern ECS_COMPONENT_DECLARE(Spike);
+
+typedef struct {
+    bool unused;
+} Mortal;
+
+extern ECS_COMPONENT_DECLARE(Mortal);
+
+// Resting bodies: below this speed (px/s) for SLEEP_TIME seconds a body sleeps
+// and is skipped by integration and the narrow phase until something wakes it
+#define SLEEP_VELOCITY_THRESHOLD 5.0f
+#define SLEEP_TIME 0.5f
+
+typedef struct {
+    float restTime; // Seconds spent below SLEEP_VELOCITY_THRESHOLD
+    bool asleep;
+} Sleep;
+
+extern ECS_COMPONENT_DECLARE(Sleep);
+
+typedef enum {
+    REPEL, ATTRACT,
+    NBODY, // Enemies attract (or repel) each other through the quadtree (Barnes-Hut)
+    FLOCK, // Enemies steer with separation, alignment and cohesion (boids)
+    PHYSICS_COUNT
+} Physics;
+
+// Softening length (px) for NBODY forces, so close pairs don't blow up
+#define NBODY_SOFTENING 15.0f
+
+// Re-sort physics bodies by Morton code once more than this share of consecutive
+// bodies runs backwards along the curve (a random order has about half)
+#define SPATIAL_SORT_DISORDER 0.25f
+
+// FLOCK: how far (px, beyond both radii) an enemy sees its flockmates
+#define FLOCK_RADIUS 40.0f
+
+// Simulation level of detail by distance from the player.
+// Bodies in LOD n advance every 2^n ticks, by 2^n * dt, and skip steering.
+typedef enum {
+    SIM_LOD_NEAR,
+    SIM_LOD_MID,
+    SIM_LOD_FAR,
+    SIM_LOD_COUNT
+} SimLod;
+
+// LOD band edges (px from the player) set up with a fixed world; 0 keeps LOD off
+#define LOD_MID_DISTANCE 500.0f
+#define LOD_FAR_DISTANCE 1000.0f
+
+// Enemies spawn small and spring up to full size
+#define ENEMY_RADIUS 15.0f
+#define ENEMY_SPAWN_RADIUS (ENEMY_RADIUS * 0.3f)
+
+// Radius springs (stiffness 1/s^2, damping 1/s: -ln of the speed kept per second)
+#define SPAWN_SPRING_STIFFNESS 700.0f
+#define SPAWN_SPRING_DAMPING 11.51f       // -ln(0.00001)
+#define DESTRUCTION_SPRING_STIFFNESS 1000.0f
+#define DESTRUCTION_SPRING_DAMPING 18.42f // -ln(1e-8), and shrinking to 0 deletes the body
+
+#define ENEMY_WAVE_SIZE 1000
+
+// Enemies from a held INPUT_SPAWN go out together every this many ticks (and on
+// the press and release), one batch and one sound at a time
+#define SPAWN_BATCH_TICKS 8
+
+typedef struct {
+    Physics physics;
+    float zoom;
+    float targetZoom;
+    int screenWidth;
+    int screenHeight;
+    unsigned int input; // InputButton flags of the current tick
+    unsigned int prevInput; // InputButton flags of the previous tick
+    unsigned int randomState; // Simulation RNG, part of the state so runs are reproducible
+    int sleepingBodies; // Bodies skipped by the last physics step
+    float nbodyStrength; // NBODY: gravitational constant, negative to repel
+    float openingAngle; // NBODY: Barnes-Hut theta, 0 = exact O(n^2) sum
+    float neighborSkin; // Verlet skin (px) for reusing neighbor lists; 0 rebuilds every tick
+    int neighborRebuilds; // Neighbor list builds so far
+    int spatialSorts; // Morton re-sorts of the physics bodies so far
+    bool backgroundQuadtree; // Build next tick's quadtree on a job worker from this tick's final positions
+    int quadtreeSwaps; // Background-built quadtrees used so far
+    float lodDistances[SIM_LOD_COUNT - 1]; // Outer edge (px from the player) of each LOD band; 0 = unbounded
+    unsigned int physicsTick; // Physics steps so far; schedules reduced-rate bodies
+    int lodBodies[SIM_LOD_COUNT]; // Bodies per LOD band in the last physics step
+    float worldWidth; // Fixed world size streamed in sectors (sectors.h); 0 = screen-bound arena
+    float worldHeight;
+    Vector2 camera; // World point shown at the screen center
+    int activeSectors; // Sectors simulated in the last tick
+    int frozenBodies; // Enemies stored in dormant sectors
+    int heldSpawns; // INPUT_SPAWN ticks not spawned yet (SPAWN_BATCH_TICKS)
+} GameState;
+
+extern ECS_COMPONENT_DECLARE(GameState);
+
+// Simulation systems in pipeline order, so tools can run and time them individually
+#define GAME_MAX_SYSTEMS 16
+
+typedef struct {
+    const char *name;
+    ecs_entity_t entity;
+} GameSystem;
+
+extern GameSystem g_game_systems[GAME_MAX_SYSTEMS];
+extern int g_game_system_count;
+
+// === Lifecycle ===
+
+// Route flecs (OS API hooks) and quadtree allocations through memtrack, so their
+// memory shows up per subsystem. Call once, before ecs_init.
+void GameInstallMemoryTracking(void);
+
+// Register components, the GameState singleton and all simulation systems.
+// Presentation systems must be registered after this so they run last.
+// seed: initial state of the simulation RNG (same seed + same inputs = same run)
+void GameInit(ecs_world_t *world, int screenWidth, int screenHeight, unsigned int seed);
+
+// Switch from the screen-bound arena to a fixed width x height world streamed in
+// sectors. Call after GameInit and before spawning; the player starts at the center.
+void GameSetWorldSize(ecs_world_t *world, float width, float height);
+
+// Release resources owned by the simulation (spatial index, sectors)
+void GameShutdown(void);
+
+// Drop per-tick caches (body order, neighbor lists, contacts, quadtree) after the
+// bodies were replaced wholesale, e.g. by SnapshotRestore. Call between ticks.
+void GameRestored(ecs_world_t *world);
+
+// === Spawning ===
+
+// Entities created from SpawnPlayer on get ids from here up. Recordings replay
+// against these ids (LOD phases, the state hash), so systems a frontend registers
+// after GameInit must not shift them.
+#define GAME_ENTITY_ID_START 0x10000
+
+// Call once setup is done: the player is the first entity of the run
+ecs_entity_t SpawnPlayer(ecs_world_t *world);
+void SpawnEnemy(ecs_world_t *world, Vector2 position);
+
+// Create count enemies in one ecs_bulk_init, straight into their final table, with
+// one spawn sound for the batch. Returns their ids (owned by flecs, valid until
+// the next structural change). Call outside systems.
+const ecs_entity_t *SpawnEnemies(ecs_world_t *world, const Vector2 *positions, int count);
+
+// Recreate an enemy thawed from a dormant sector: full size, already moving, silent.
+// An instance of the enemy prefab like SpawnEnemies makes, but safe inside systems.
+ecs_entity_t RestoreEnemy(ecs_world_t *world, Vector2 position, Vector2 velocity, float radius, float health);
+
+// Put a resting body back into simulation
+void WakeBody(Sleep *sleep);
+
+// === Ticking ===
+
+// Apply one tick of input to GameState (spawns, mode switches, arena size)
+void GameApplyInput(ecs_world_t *world, const TickInput *input);
+
+// Apply input and advance the simulation by input->dt
+void GameTick(ecs_world_t *world, const TickInput *input);
+
+// Contact enter/stay/exit events of the last physics step (pairs keyed by entity id)
+const ContactEvent *GameContactEvents(int *count);
+
+// Bodies of a quadtree node too small on screen to draw one by one
+typedef struct {
+    Vector2 center;      // Centroid of the bodies
+    float radius;        // Radius of a circle with their combined area
+    int count;
+    ecs_entity_t entity; // One of them, for its color
+} BodyCluster;
+
+// Entities whose bodies may overlap a world rectangle, from the last physics
+// step's quadtree. A superset: callers still test exact bounds. Quadtree nodes no
+// larger than clusterSize come back as clusters instead (0 = never). The arrays
+// are frame scratch. Bodies created since the step (thawed sectors) are not listed.
+int GameQueryVisible(AABB view, float clusterSize, const ecs_entity_t **entities,
+                     const BodyCluster **clusters, int *clusterCount);
+
+// === Determinism ===
+
+// Random integer in [min, max] from the simulation RNG (replaces GetRandomValue)
+int GameRandomValue(GameState *state, int min, int max);
+
+// Hash of all simulated state (bodies and GameState), for replay verification
+unsigned int GameStateHash(ecs_world_t *world);
+
+#endif // GAME_H
@@ -0,0 +1,373 @@
+#include "jobs.h"
+#include "memtrack.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+typedef struct {
+    JobFn fn;
+    void* data;
+    JobCounter* counter;
+} Job;
+
+struct JobContinuation {
+    Job job;
+    JobContinuation* next;
+};
+
+// Chase-Lev deque: the owner pushes and pops at bottom, thieves take from top
+typedef struct {
+    atomic_long top;
+    atomic_long bottom;
+    Job jobs[JOBS_DEQUE_CAPACITY];
+} JobDeque;
+
+typedef struct {
+    pthread_t threads[JOBS_MAX_WORKERS];
+    JobDeque* deques; // One per worker, worker 0 is the thread that called jobs_init
+    int worker_count; // Including worker 0
+    bool running;
+
+    // Submissions from threads that are not workers
+    Job shared[JOBS_DEQUE_CAPACITY];
+    int shared_head;
+    int shared_count;
+
+    pthread_mutex_t mutex; // Guards the shared queue and sleeping
+    pthread_cond_t wake;
+    pthread_mutex_t counter_mutex; // Guards counter continuations
+    atomic_int queued;     // Jobs in any queue, so idle workers know when to sleep
+    atomic_int sleepers;
+    atomic_bool quit;
+} JobSystem;
+
+static JobSystem g_jobs = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .counter_mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+static _Thread_local int t_worker = -1;
+
+// === Deque ===
+
+static bool deque_push(JobDeque* deque, Job job) {
+    const long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    const long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (b - t >= JOBS_DEQUE_CAPACITY) return false;
+
+    deque->jobs[b & (JOBS_DEQUE_CAPACITY - 1)] = job;
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+static bool deque_pop(JobDeque* deque, Job* job) {
+    const long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (t > b) {
+        // Empty
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+
+    *job = deque->jobs[b & (JOBS_DEQUE_CAPACITY - 1)];
+    if (t == b) {
+        // Last job: race thieves for it
+        const bool won = atomic_compare_exchange_strong_explicit(
+            &deque->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+static bool deque_steal(JobDeque* deque, Job* job) {
+    long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const long b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (t >= b) return false;
+
+    *job = deque->jobs[t & (JOBS_DEQUE_CAPACITY - 1)];
+    return atomic_compare_exchange_strong_explicit(
+        &deque->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+// === Scheduling ===
+
+static void wake_sleepers(void) {
+    if (atomic_load(&g_jobs.sleepers) > 0) {
+        pthread_mutex_lock(&g_jobs.mutex);
+        pthread_cond_broadcast(&g_jobs.wake);
+        pthread_mutex_unlock(&g_jobs.mutex);
+    }
+}
+
+static void run_job(Job job);
+
+// Queue a job whose counter was already incremented
+static void enqueue(Job job) {
+    if (!g_jobs.running) {
+        run_job(job);
+        return;
+    }
+
+    // Count first, so the count never drops below zero when a thief is quick
+    atomic_fetch_add(&g_jobs.queued, 1);
+
+    bool queued;
+    if (t_worker >= 0) {
+        queued = deque_push(&g_jobs.deques[t_worker], job);
+    } else {
+        pthread_mutex_lock(&g_jobs.mutex);
+        queued = g_jobs.shared_count < JOBS_DEQUE_CAPACITY;
+        if (queued) {
+            g_jobs.shared[(g_jobs.shared_head + g_jobs.shared_count) % JOBS_DEQUE_CAPACITY] = job;
+            g_jobs.shared_count++;
+        }
+        pthread_mutex_unlock(&g_jobs.mutex);
+    }
+
+    if (!queued) {
+        // Back-pressure: running it here is always correct, just not parallel
+        atomic_fetch_sub(&g_jobs.queued, 1);
+        run_job(job);
+        return;
+    }
+
+    wake_sleepers();
+}
+
+// Own deque first, then the shared queue, then steal starting after ourselves
+static bool find_job(Job* job) {
+    const int self = t_worker;
+    if (self >= 0 && deque_pop(&g_jobs.deques[self], job)) goto found;
+
+    if (atomic_load_explicit(&g_jobs.queued, memory_order_relaxed) == 0) return false;
+
+    pthread_mutex_lock(&g_jobs.mutex);
+    if (g_jobs.shared_count > 0) {
+        *job = g_jobs.shared[g_jobs.shared_head];
+        g_jobs.shared_head = (g_jobs.shared_head + 1) % JOBS_DEQUE_CAPACITY;
+        g_jobs.shared_count--;
+        pthread_mutex_unlock(&g_jobs.mutex);
+        goto found;
+    }
+    pthread_mutex_unlock(&g_jobs.mutex);
+
+    for (int k = 1; k <= g_jobs.worker_count; k++) {
+        const int victim = (self + k + g_jobs.worker_count) % g_jobs.worker_count;
+        if (victim != self && deque_steal(&g_jobs.deques[victim], job)) goto found;
+    }
+    return false;
+
+found:
+    atomic_fetch_sub(&g_jobs.queued, 1);
+    return true;
+}
+
+static void complete(JobCounter* counter) {
+    // Detach the continuations before the decrement: once the count reads zero a
+    // waiter may return and the counter (often on its stack) is gone
+    pthread_mutex_lock(&g_jobs.counter_mutex);
+    JobContinuation* continuation = NULL;
+    if (atomic_load_explicit(&counter->pending, memory_order_relaxed) == 1) {
+        continuation = counter->continuations;
+        counter->continuations = NULL;
+    }
+    atomic_fetch_sub_explicit(&counter->pending, 1, memory_order_acq_rel);
+    pthread_mutex_unlock(&g_jobs.counter_mutex);
+
+    // Last job of the counter: release what was deferred behind it
+    while (continuation) {
+        JobContinuation* next = continuation->next;
+        enqueue(continuation->job);
+        memtrack_free(continuation);
+        continuation = next;
+    }
+}
+
+static void run_job(Job job) {
+    job.fn(job.data);
+    if (job.counter) complete(job.counter);
+}
+
+static void* worker_main(void* arg) {
+    t_worker = (int) (long) arg;
+
+    while (!atomic_load(&g_jobs.quit)) {
+        Job job;
+        if (find_job(&job)) {
+            run_job(job);
+            continue;
+        }
+
+        // Nothing to do: sleep until something is queued
+        pthread_mutex_lock(&g_jobs.mutex);
+        atomic_fetch_add(&g_jobs.sleepers, 1);
+        while (atomic_load(&g_jobs.queued) == 0 && !atomic_load(&g_jobs.quit)) {
+            pthread_cond_wait(&g_jobs.wake, &g_jobs.mutex);
+        }
+        atomic_fetch_sub(&g_jobs.sleepers, 1);
+        pthread_mutex_unlock(&g_jobs.mutex);
+    }
+    return NULL;
+}
+
+// === Lifecycle ===
+
+bool jobs_init(int worker_count) {
+    if (g_jobs.running) return true;
+
+    if (worker_count < 0) {
+        worker_count = (int) sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    }
+    if (worker_count > JOBS_MAX_WORKERS - 1) worker_count = JOBS_MAX_WORKERS - 1;
+    if (worker_count <= 0) return true; // Inline
+
+    g_jobs.deques = memtrack_calloc(MEMTRACK_JOBS, worker_count + 1, sizeof(JobDeque));
+    if (!g_jobs.deques) return false;
+
+    atomic_store(&g_jobs.quit, false);
+    atomic_store(&g_jobs.queued, 0);
+    g_jobs.shared_head = 0;
+    g_jobs.shared_count = 0;
+    g_jobs.worker_count = 1;
+    g_jobs.running = true;
+    t_worker = 0;
+
+    for (int i = 1; i <= worker_count; i++) {
+        if (pthread_create(&g_jobs.threads[i], NULL, worker_main, (void*) (long) i) != 0) break;
+        g_jobs.worker_count++;
+    }
+
+    if (g_jobs.worker_count == 1) {
+        jobs_shutdown();
+        return false;
+    }
+    return true;
+}
+
+void jobs_shutdown(void) {
+    if (!g_jobs.running) return;
+
+    // Drain: nothing queued may be lost
+    Job job;
+    while (find_job(&job)) {
+        run_job(job);
+    }
+
+    atomic_store(&g_jobs.quit, true);
+    pthread_mutex_lock(&g_jobs.mutex);
+    pthread_cond_broadcast(&g_jobs.wake);
+    pthread_mutex_unlock(&g_jobs.mutex);
+
+    for (int i = 1; i < g_jobs.worker_count; i++) {
+        pthread_join(g_jobs.threads[i], NULL);
+    }
+
+    memtrack_free(g_jobs.deques);
+    g_jobs.deques = NULL;
+    g_jobs.worker_count = 0;
+    g_jobs.running = false;
+    t_worker = -1;
+}
+
+int jobs_thread_count(void) {
+    return g_jobs.running ? g_jobs.worker_count : 1;
+}
+
+// === Submitting ===
+
+void jobs_submit(JobFn fn, void* data, JobCounter* counter) {
+    if (counter) atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+    enqueue((Job){fn, data, counter});
+}
+
+void jobs_submit_after(JobCounter* dependency, JobFn fn, void* data, JobCounter* counter) {
+    if (counter) atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+    const Job job = {fn, data, counter};
+
+    // complete() decrements under the same mutex, so a continuation added while
+    // the count is still positive is always released
+    pthread_mutex_lock(&g_jobs.counter_mutex);
+    if (!jobs_done(dependency)) {
+        JobContinuation* continuation = memtrack_alloc(MEMTRACK_JOBS, sizeof(JobContinuation));
+        if (continuation) {
+            continuation->job = job;
+            continuation->next = dependency->continuations;
+            dependency->continuations = continuation;
+            pthread_mutex_unlock(&g_jobs.counter_mutex);
+            return;
+        }
+        // Out of memory: wait for the dependency here instead
+        pthread_mutex_unlock(&g_jobs.counter_mutex);
+        jobs_wait(dependency);
+    } else {
+        pthread_mutex_unlock(&g_jobs.counter_mutex);
+    }
+
+    enqueue(job);
+}
+
+void jobs_wait(JobCounter* counter) {
+    while (!jobs_done(counter)) {
+        Job job;
+        if (find_job(&job)) {
+            run_job(job);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+// === Parallel for ===
+
+typedef struct {
+    JobRangeFn fn;
+    void* data;
+    int count;
+    int chunk;
+    atomic_int next; // First index not yet claimed
+} ParallelFor;
+
+// Helpers claim chunks until none are left, so faster threads take more of them
+static void parallel_for_job(void* data) {
+    ParallelFor* pf = data;
+    for (;;) {
+        const int begin = atomic_fetch_add_explicit(&pf->next, pf->chunk, memory_order_relaxed);
+        if (begin >= pf->count) return;
+        const int end = begin + pf->chunk < pf->count ? begin + pf->chunk : pf->count;
+        pf->fn(pf->data, begin, end);
+    }
+}
+
+void jobs_parallel_for(int count, int min_chunk, JobRangeFn fn, void* data) {
+    if (count <= 0) return;
+
+    const int threads = jobs_thread_count();
+    if (min_chunk < 1) min_chunk = 1;
+    int chunk = count / (threads * JOBS_CHUNKS_PER_WORKER);
+    if (chunk < min_chunk) chunk = min_chunk;
+
+    const int chunks = (count + chunk - 1) / chunk;
+    if (threads == 1 || chunks == 1) {
+        fn(data, 0, count);
+        return;
+    }
+
+    ParallelFor pf = {.fn = fn, .data = data, .count = count, .chunk = chunk};
+    atomic_init(&pf.next, 0);
+
+    // One helper per other thread at most; the caller works too
+    JobCounter counter = {0};
+    const int helpers = chunks - 1 < threads - 1 ? chunks - 1 : threads - 1;
+    for (int i = 0; i < helpers; i++) {
+        jobs_submit(parallel_for_job, &pf, &counter);
+    }
+    parallel_for_job(&pf);
+    jobs_wait(&counter);
+}
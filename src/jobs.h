@@ -0,0 +1,74 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Work-stealing job system.
+//
+// jobs_init starts a fixed pool of worker threads; the thread that called it
+// becomes worker 0 and runs jobs whenever it waits. Every worker owns a deque:
+// it pushes and pops at the bottom (LIFO, cache-warm), idle workers steal from
+// the top of the others'. Threads that are not workers submit through a shared
+// queue instead.
+//
+// Completion is tracked with counters: every job submitted with a counter
+// increments it, and finishing the job decrements it. Waiting on a counter runs
+// other jobs instead of blocking, and jobs can be deferred until a counter
+// reaches zero (dependencies).
+//
+// Without jobs_init (or with 0 workers) everything runs inline on the caller,
+// so code using jobs needs no special single-threaded path.
+
+#define JOBS_MAX_WORKERS 32
+#define JOBS_DEQUE_CAPACITY 4096 // Per worker; a full deque runs new jobs inline
+
+// parallel_for splits work into about this many chunks per worker, so workers
+// that finish early can pick up the remainder
+#define JOBS_CHUNKS_PER_WORKER 4
+
+typedef void (*JobFn)(void* data);
+typedef void (*JobRangeFn)(void* data, int begin, int end);
+
+typedef struct JobContinuation JobContinuation;
+
+// Zero-initialized counters are valid (and complete). Don't reuse a counter
+// while jobs are still pending on it or deferred behind it, and submit all of a
+// counter's jobs before deferring anything behind it.
+typedef struct {
+    atomic_int pending;
+    JobContinuation* continuations; // Jobs waiting for pending to reach 0
+} JobCounter;
+
+// === Lifecycle ===
+
+// Start worker_count threads besides the caller (-1 = one per core, minus the caller).
+// Returns false if the workers could not be started; jobs then run inline.
+bool jobs_init(int worker_count);
+
+// Finish queued jobs and join the workers
+void jobs_shutdown(void);
+
+// Threads running jobs, including the one that called jobs_init (1 when inline)
+int jobs_thread_count(void);
+
+// === Submitting ===
+
+// Queue fn(data); counter may be NULL
+void jobs_submit(JobFn fn, void* data, JobCounter* counter);
+
+// Queue fn(data) once dependency reaches zero (immediately if it already has)
+void jobs_submit_after(JobCounter* dependency, JobFn fn, void* data, JobCounter* counter);
+
+// Run queued jobs until counter reaches zero
+void jobs_wait(JobCounter* counter);
+
+static inline bool jobs_done(JobCounter* counter) {
+    return atomic_load_explicit(&counter->pending, memory_order_acquire) == 0;
+}
+
+// Call fn(data, begin, end) over [0, count) in chunks of at least min_chunk and
+// return when all are done. Chunks run concurrently and in no particular order.
+void jobs_parallel_for(int count, int min_chunk, JobRangeFn fn, void* data);
+
+#endif // JOBS_H
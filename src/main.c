@@ -2,132 +2,57 @@
 #include <dirent.h>      // For directory operations
 #include <string.h>      // For string manipulation
 #include <sys/stat.h>    // For file stat checks
+#include <stdlib.h>
+#include <time.h>
 #include <flecs.h>
 #include <MacTypes.h>
 #include <math.h>
+#include <stdatomic.h>
 #include <raylib.h>
 #include "raymath.h"
 #include "audio.h"
 #include "spatial.h"
-
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
-#define CLAMP(x, min, max) ((x) < (min) ? (min) : ((x) > (max) ? (max) : (x)))
+#include "game.h"
+#include "replay.h"
+#include "jobs.h"
+#include "profiler.h"
+#include "memtrack.h"
+#include "render_commands.h"
+#include "render.h"
+#include "sim_pipeline.h"
+#include "frame_arena.h"
+#include "snapshot.h"
+#include "rewind.h"
 
 float SmoothDamp(float current, float target, float smoothTime) {
     return current + (target - current) * smoothTime;
 }
 
-const int MAX_ENTITIES = 10000;
-
-// Spatial partitioning globals
-Quadtree *g_quadtree = NULL;
-bool g_debug_spatial = false;
-
-typedef enum {
-    COLOR_PALETTE_0,
-    COLOR_PALETTE_1,
-    COLOR_PALETTE_2,
-    COLOR_PALETTE_3,
-    COLOR_PALETTE_4,
-    COLOR_PALETTE_5,
-    COLOR_PALETTE_6,
-    COLOR_PALETTE_7,
-    COLOR_PALETTE_8,
-    COLOR_PALETTE_9,
-    COLOR_PALETTE_10,
-    COLOR_PALETTE_11,
-    COLOR_PALETTE_12,
-    COLOR_PALETTE_13,
-    COLOR_PALETTE_14,
-    COLOR_PALETTE_15,
-    COLOR_BACKGROUND,
-    COLOR_FOREGROUND,
-    COLOR_CURSOR,
-    COLOR_SELECTION
-} ThemeColor;
-
-// ECS
-typedef struct {
-    float health;
-} Health;
-
-ECS_COMPONENT_DECLARE(Health);
-
-typedef struct {
-    Vector2 velocity;
-} Velocity;
-
-ECS_COMPONENT_DECLARE(Velocity);
-
-typedef struct {
-    bool defaultValue;
-} PlayerInput;
-
-ECS_COMPONENT_DECLARE(PlayerInput);
-
-typedef struct {
-    bool directionSet;
-} EnemyInput;
-
-ECS_COMPONENT_DECLARE(EnemyInput);
-
-typedef struct {
-    Vector2 position;
-    float radius;
-    ThemeColor colorIndex;
-} Renderable;
-
-ECS_COMPONENT_DECLARE(Renderable);
-
-typedef struct {
-    float currentRadius;
-    float targetRadius;
-    float velocity;
-    float damping;
-    float stiffness;
-} SpringAnimation;
-
-ECS_COMPONENT_DECLARE(SpringAnimation);
+// Read by the simulation thread when pipelined
+atomic_bool g_debug_spatial = false;
+bool g_show_profiler = false;
 
-typedef struct {
-    float range;
-    float currentRange;
-    float targetRange;
-    float velocity;
-    float damping;
-    float stiffness;
-    ThemeColor colorIndex;
-    bool active;
-    bool wasActive;
-} AttractionRangeVFX;
-
-ECS_COMPONENT_DECLARE(AttractionRangeVFX);
-
-typedef struct {
-    bool unused;
-} Spike;
+// Frames written by the trace key
+#define PROFILER_TRACE_FRAMES 120
 
-ECS_COMPONENT_DECLARE(Spike);
-
-typedef struct {
-    bool unused;
-} Mortal;
-
-ECS_COMPONENT_DECLARE(Mortal);
+// Written by the save key, read back by the load key
+#define SAVE_STATE_PATH "savestate.bin"
 
+// Requests from the keyboard to the simulation, served before its next tick
 typedef enum {
-    REPEL, ATTRACT,
-    PHYSICS_COUNT
-} Physics;
-
-typedef struct {
-    Physics physics;
-    float zoom;
-    float targetZoom;
-} GameState;
-
-ECS_COMPONENT_DECLARE(GameState);
+    SIM_REQUEST_REWIND = 1 << 0, // Held: step back one frame instead of ticking
+    SIM_REQUEST_SAVE = 1 << 1,
+    SIM_REQUEST_LOAD = 1 << 2
+} SimRequest;
+
+atomic_uint g_sim_requests = 0;
+
+// World to screen: the camera sits at the screen center, scaled by zoom around it
+Vector2 WorldToScreen(const GameState *state, Vector2 position) {
+    const Vector2 screenCenter = {state->screenWidth / 2.0f, state->screenHeight / 2.0f};
+    const Vector2 offset = Vector2Subtract(position, state->camera);
+    return Vector2Add(screenCenter, Vector2Scale(offset, state->zoom));
+}
 
 // UI
 typedef struct {
@@ -159,6 +84,40 @@ Theme themes[MAX_THEMES];
 int themeCount = 0;
 int currentThemeIndex = 0;
 
+// Everything drawn from one simulated frame. Filled by the simulation, then only
+// read by the renderer, which may be a frame behind (see sim_pipeline.h).
+typedef struct {
+    RenderCommandBuffer commands;   // Bodies and VFX in screen space; palette resolved when drawn
+    QuadtreeDebugSnapshot quadtree; // Empty unless spatial debug is on
+    Vector2 camera;
+    float zoom;
+    Physics physics;
+    int enemyCount;
+    int sleepingBodies;
+    float worldWidth;
+    int activeSectors;
+    int frozenBodies;
+} FrameSnapshot;
+
+static FrameSnapshot g_snapshots[SIM_PIPELINE_SLOTS];
+
+// Snapshot command buffer the render systems record into this tick
+static RenderCommandBuffer *g_render;
+
+// ThemeColor -> color lookup table for the render buffer, resolved once per frame
+void ThemePalette(const Theme *theme, Color palette[RENDER_PALETTE_SIZE]) {
+    for (int i = 0; i < RENDER_PALETTE_SIZE; i++) {
+        palette[i] = WHITE;
+    }
+    for (int i = COLOR_PALETTE_0; i <= COLOR_PALETTE_15; i++) {
+        palette[i] = theme->palette[i];
+    }
+    palette[COLOR_BACKGROUND] = theme->background;
+    palette[COLOR_FOREGROUND] = theme->foreground;
+    palette[COLOR_CURSOR] = theme->cursor_color;
+    palette[COLOR_SELECTION] = theme->selection_background;
+}
+
 void ApplyTheme(int themeIndex) {
     if (themeIndex >= 0) {
         currentThemeIndex = themeIndex % themeCount;
@@ -278,372 +237,21 @@ int ScanThemeDirectory(const char *dirPath, Theme *themes, int maxThemes) {
     return themeCount;
 }
 
-void TriggerDestruction(ecs_world_t *world, ecs_entity_t entity) {
-    // Add spring animation to shrink the entity to 0
-    const Renderable *r = ecs_get(world, entity, Renderable);
-    if (r) {
-        ecs_set(world, entity, SpringAnimation, {
-                .currentRadius = r->radius,
-                .targetRadius = 0,
-                .velocity = 0,
-                .damping = 0.00000001f,
-                .stiffness = 1000.0f
-                });
-    }
-
-    // PlayDesctructionSound();
-}
-
-void PlayerMovementSystem(ecs_iter_t *it) {
-    Velocity *v = ecs_field(it, Velocity, 0);
-
-    float speed = 0.0f;
-
-    for (int i = 0; i < it->count; i++) {
-        const float PLAYER_SPEED = 200.0f;
-        const float ACCELERATION = 2.0f; // Higher = faster acceleration
-        Vector2 direction = {0, 0};
-
-        if (IsKeyDown(KEY_RIGHT)) direction.x = 1.0f;
-        if (IsKeyDown(KEY_LEFT)) direction.x = -1.0f;
-        if (IsKeyDown(KEY_UP)) direction.y = -1.0f;
-        if (IsKeyDown(KEY_DOWN)) direction.y = 1.0f;
-
-        // Calculate target velocity
-        Vector2 targetVelocity;
-        float magnitude = Vector2Length(direction);
-        if (magnitude > 0) {
-            direction = Vector2Scale(direction, 1.0f / magnitude);
-            targetVelocity = Vector2Scale(direction, PLAYER_SPEED);
-        } else {
-            targetVelocity = (Vector2){0, 0};
-        }
-
-        // Smoothly interpolate current velocity towards target
-        v[i].velocity.x += (targetVelocity.x - v[i].velocity.x) * ACCELERATION * GetFrameTime();
-        v[i].velocity.y += (targetVelocity.y - v[i].velocity.y) * ACCELERATION * GetFrameTime();
-
-        speed = Vector2Length(v[i].velocity);
-    }
-
-    GameState *state = ecs_singleton_get_mut(it->world, GameState);
-    state->targetZoom = 1.0f - speed * 0.001f;
-    state->zoom = state->targetZoom;
-    // float smoothSpeed = 10.0f; // Higher = faster transition
-    // state->zoom += (state->targetZoom - state->zoom) * smoothSpeed * GetFrameTime();
-}
-
-void EnemyMovementSystem(ecs_iter_t *it) {
-    Velocity *v = ecs_field(it, Velocity, 0);
-    EnemyInput *e = ecs_field(it, EnemyInput, 1);
-    const Renderable *r = ecs_field(it, Renderable, 2);
-
-    const ecs_world_t *world = it->world;
-    const ecs_entity_t player = ecs_lookup(world, "Player");
-    const ecs_id_t renderable_id = ecs_field_id(it, 2);
-    const Renderable *playerRenderable = ecs_get_id(world, player, renderable_id);
-    const Vector2 playerPos = playerRenderable->position;
-
-    const float MAX_ATTRACTION_RANGE = (float) MIN(GetScreenWidth(), GetScreenHeight()) / 2;
-
-    for (int i = 0; i < it->count; i++) {
-        const float ENEMY_SPEED = 100.0f;
-        if (!e[i].directionSet && ENEMY_SPEED > 0) {
-            e[i].directionSet = true;
-            v[i].velocity = (Vector2){
-                .x = (float) GetRandomValue(-(int) ENEMY_SPEED, (int) ENEMY_SPEED),
-                .y = (float) GetRandomValue(-(int) ENEMY_SPEED, (int) ENEMY_SPEED)
-            };
-        }
-
-        if (IsKeyDown(KEY_SPACE)) {
-            const float MAX_ATTRACTION_FORCE = 5.0f;
-            Vector2 dir = {
-                .x = playerPos.x - r[i].position.x,
-                .y = playerPos.y - r[i].position.y
-            };
-
-            const float magnitude = sqrtf(dir.x * dir.x + dir.y * dir.y);
-
-            // Normalize direction
-            if (magnitude > 0) {
-                dir.x /= magnitude;
-                dir.y /= magnitude;
-            }
-
-            float attractionStrength = fmaxf(0, 1.0f - (magnitude / MAX_ATTRACTION_RANGE));
-            Vector2 attractionForce = (Vector2){
-                dir.x * MAX_ATTRACTION_FORCE * attractionStrength,
-                dir.y * MAX_ATTRACTION_FORCE * attractionStrength
-            };
-            v[i].velocity = Vector2Add(v[i].velocity, attractionForce);
-        }
-    }
-}
-
-void GlobalPositionUpdateSystem(ecs_iter_t *it) {
-    GameState *state = ecs_singleton_get(it->world, GameState);
-
-    // Temporary storage for all entities
-    typedef struct {
-        ecs_entity_t entity;
-        Renderable *renderable;
-        Velocity *velocity;
-    } EntityRef;
-
-    EntityRef entities[MAX_ENTITIES];
-    int entityCount = 0;
-    int tableCount = 0;
-
-    ecs_query_t *q = ecs_query(it->world, {
-       .terms = {
-       { ecs_id(Renderable) }, { ecs_id(Velocity) },
-       }
-    });
-
-    // Collect all entities from all tables
-    ecs_iter_t query_it = ecs_query_iter(it->world, q);
-    while (ecs_query_next(&query_it)) {
-        tableCount++;
-        Renderable *r = ecs_field(&query_it, Renderable, 0);
-        Velocity *v = ecs_field(&query_it, Velocity, 1);
-
-        for (int i = 0; i < query_it.count && entityCount < MAX_ENTITIES; i++) {
-            entities[entityCount].entity = query_it.entities[i];
-            entities[entityCount].renderable = &r[i];
-            entities[entityCount].velocity = &v[i];
-            entityCount++;
-        }
-    }
-
-    const int screenWidth = GetScreenWidth();
-    const int screenHeight = GetScreenHeight();
-
-    // Calculate zoom-adjusted world boundaries
-    const Vector2 screenCenter = {screenWidth / 2.0f, screenHeight / 2.0f};
-    const float zoom = state->zoom;
-    const float worldMinX = screenCenter.x - screenCenter.x / zoom;
-    const float worldMaxX = screenCenter.x + screenCenter.x / zoom;
-    const float worldMinY = screenCenter.y - screenCenter.y / zoom;
-    const float worldMaxY = screenCenter.y + screenCenter.y / zoom;
-
-    // Rebuild quadtree for broad-phase collision detection
-    // Quadtree bounds match the zoom-adjusted world space
-    if (g_quadtree == NULL) {
-        AABB world_bounds = {worldMinX, worldMinY, worldMaxX, worldMaxY};
-        g_quadtree = quadtree_create(world_bounds);
-    } else {
-        quadtree_clear(g_quadtree);
-        // Update world bounds in case screen size or zoom changed
-        g_quadtree->world_bounds = (AABB){worldMinX, worldMinY, worldMaxX, worldMaxY};
-        // Also update the root node's bounds to match
-        if (g_quadtree->root) {
-            g_quadtree->root->bounds = (AABB){worldMinX, worldMinY, worldMaxX, worldMaxY};
-        }
-    }
-
-    // Insert all entities into quadtree
-    for (int i = 0; i < entityCount; i++) {
-        AABB entity_bounds = aabb_from_circle(
-            entities[i].renderable->position,
-            entities[i].renderable->radius
-        );
-        quadtree_insert(g_quadtree, i, entity_bounds);
-    }
-
-    // Update positions and handle collisions across all tables
-    for (int i = 0; i < entityCount; i++) {
-        entities[i].renderable->position.x += entities[i].velocity->velocity.x *
-                GetFrameTime();
-        entities[i].renderable->position.y += entities[i].velocity->velocity.y *
-                GetFrameTime();
-
-        // Query quadtree for nearby entities (broad-phase)
-        AABB query_bounds = aabb_from_circle(
-            entities[i].renderable->position,
-            entities[i].renderable->radius
-        );
-
-        int nearby_indices[256]; // Max nearby entities to check
-        int nearby_count = quadtree_query(g_quadtree, query_bounds, nearby_indices, 256);
-
-        // Check collisions only with nearby entities (narrow-phase)
-        for (int k = 0; k < nearby_count; k++) {
-            int j = nearby_indices[k];
-
-            // Skip self and already-checked pairs
-            if (j <= i) continue;
-
-            Vector2 dir = {
-                .x = entities[j].renderable->position.x - entities[i].renderable->position.x,
-                .y = entities[j].renderable->position.y - entities[i].renderable->position.y
-            };
-
-            const float magnitude = sqrtf(dir.x * dir.x + dir.y * dir.y);
-            const float boundary = entities[j].renderable->radius + entities[i].renderable->radius;
-            if (magnitude > boundary) {
-                continue;
-            }
-
-            // Check for Spike
-            const Spike *spike_i = ecs_get(it->world, entities[i].entity, Spike);
-            const Spike *spike_j = ecs_get(it->world, entities[j].entity, Spike);
-            const Mortal *mortal_i = ecs_get(it->world, entities[i].entity, Mortal);
-            const Mortal *mortal_j = ecs_get(it->world, entities[j].entity, Mortal);
-
-            // Destroy both
-            if (spike_i && mortal_i && spike_j && mortal_j) {
-                TriggerDestruction(it->world, entities[i].entity);
-                TriggerDestruction(it->world, entities[j].entity);
-                continue;
-            }
-
-            if (spike_i && mortal_j) {
-                TriggerDestruction(it->world, entities[j].entity);
-                continue;
-            }
-
-            if (spike_j && mortal_i) {
-                TriggerDestruction(it->world, entities[i].entity);
-                continue;
-            }
-
-            // Normalize direction
-            if (magnitude > 0) {
-                dir.x /= magnitude;
-                dir.y /= magnitude;
-            }
-
-            // Adjust positions
-            const float adjustment = (boundary - magnitude) * 0.5f;
-            entities[i].renderable->position.x -= dir.x * adjustment;
-            entities[i].renderable->position.y -= dir.y * adjustment;
-            entities[j].renderable->position.x += dir.x * adjustment;
-            entities[j].renderable->position.y += dir.y * adjustment;
-
-            // Adjust velocity
-            // Calculate relative velocity
-            Vector2 relativeVelocity = {
-                entities[j].velocity->velocity.x - entities[i].velocity->velocity.x,
-                entities[j].velocity->velocity.y - entities[i].velocity->velocity.y
-            };
-
-            // Calculate velocity along the collision normal (dir)
-            float velocityAlongNormal = relativeVelocity.x * dir.x + relativeVelocity.y * dir.y;
-
-            // Only resolve if entities are moving toward each other
-            if (state->physics == ATTRACT ? velocityAlongNormal > 0 : velocityAlongNormal < 0) {
-                // Restitution (bounciness): 0 = no bounce, 1 = perfect bounce
-                const float restitution = 0.9f;
-
-                // Calculate impulse scalar
-                float impulseMagnitude = -(1 + restitution) * velocityAlongNormal;
-                impulseMagnitude *= 0.5f; // Divide by 2 because both entities have equal "mass"
-
-                // Apply impulse to both entities
-                entities[i].velocity->velocity.x -= dir.x * impulseMagnitude;
-                entities[i].velocity->velocity.y -= dir.y * impulseMagnitude;
-
-                entities[j].velocity->velocity.x += dir.x * impulseMagnitude;
-                entities[j].velocity->velocity.y += dir.y * impulseMagnitude;
-            }
-        }
-
-        // World boundary collision (zoom-adjusted)
-        if (entities[i].renderable->position.x < worldMinX + entities[i].renderable->radius ||
-            entities[i].renderable->position.x > worldMaxX - entities[i].renderable->radius) {
-            entities[i].velocity->velocity.x *= -1;
-            entities[i].renderable->position.x = CLAMP(entities[i].renderable->position.x,
-                                                       worldMinX + entities[i].renderable->radius,
-                                                       worldMaxX - entities[i].renderable->radius);
-            PlayBounceSoundWithVelocity(entities[i].velocity->velocity.x);
-        }
-
-        if (entities[i].renderable->position.y < worldMinY + entities[i].renderable->radius ||
-            entities[i].renderable->position.y > worldMaxY - entities[i].renderable->radius) {
-            entities[i].velocity->velocity.y *= -1;
-            entities[i].renderable->position.y = CLAMP(entities[i].renderable->position.y,
-                                                       worldMinY + entities[i].renderable->radius,
-                                                       worldMaxY - entities[i].renderable->radius);
-            PlayBounceSoundWithVelocity(entities[i].velocity->velocity.y);
-        }
-    }
-
-    ecs_query_fini(q);
-}
-
+// Draws only bodies the quadtree places in the zoom-adjusted view
 void RenderSystem(ecs_iter_t *it) {
-    const Renderable *r = ecs_field(it, Renderable, 0);
-    Theme *theme = &themes[currentThemeIndex];
-
-    GameState *state = ecs_singleton_get(it->world, GameState);
-
-    for (int i = 0; i < it->count; i++) {
-        Color color;
-        switch (r[i].colorIndex) {
-            case COLOR_BACKGROUND: color = theme->background;
-                break;
-            case COLOR_FOREGROUND: color = theme->foreground;
-                break;
-            case COLOR_CURSOR: color = theme->cursor_color;
-                break;
-            case COLOR_SELECTION: color = theme->selection_background;
-                break;
-            default:
-                if (r[i].colorIndex >= COLOR_PALETTE_0 && r[i].colorIndex <= COLOR_PALETTE_15) {
-                    color = theme->palette[r[i].colorIndex];
-                } else {
-                    color = WHITE;
-                }
-                break;
-        }
-        Vector2 screenCenter = {
-            GetScreenWidth() / 2.0f, GetScreenHeight() /
-                                     2.0f
-        };
-        Vector2 offset = Vector2Subtract(r[i].position, screenCenter);
-        Vector2 scaledOffset = Vector2Scale(offset, state->zoom);
-        Vector2 scaledPosition = Vector2Add(screenCenter, scaledOffset);
-
-        DrawCircleV(scaledPosition, r[i].radius * state->zoom, color);
-    }
-}
-
-void SpringAnimationSystem(ecs_iter_t *it) {
-    SpringAnimation *spring = ecs_field(it, SpringAnimation, 0);
-    Renderable *renderable = ecs_field(it, Renderable, 1);
-
-    for (int i = 0; i < it->count; i++) {
-        // Spring physics
-        float force = (spring[i].targetRadius - spring[i].currentRadius) * spring[i].stiffness;
-        spring[i].velocity += force * GetFrameTime();
-        spring[i].velocity *= powf(spring[i].damping, GetFrameTime());
-        spring[i].currentRadius += spring[i].velocity * GetFrameTime();
-
-        // Update renderable radius
-        renderable[i].radius = spring[i].currentRadius;
-
-        // Remove component when animation is complete
-        if (fabsf(spring[i].currentRadius - spring[i].targetRadius) < 0.1f &&
-            fabsf(spring[i].velocity) < 0.1f) {
-            renderable[i].radius = spring[i].targetRadius;
-
-            if (spring[i].targetRadius <= 0.0f) {
-                ecs_delete(it->world, it->entities[i]);
-            } else {
-                ecs_remove_id(it->world, it->entities[i], ecs_id(SpringAnimation));
-            }
-        }
-    }
+    PROFILE_ZONE("RenderSystem");
+    const GameState *state = ecs_singleton_get(it->world, GameState);
+    RecordBodies(it->world, g_render, state->screenWidth, state->screenHeight);
 }
 
 void AttractionRangeVFXSystem(ecs_iter_t *it) {
+    PROFILE_ZONE("AttractionRangeVFXSystem");
     AttractionRangeVFX *vfx = ecs_field(it, AttractionRangeVFX, 0);
     const Renderable *renderable = ecs_field(it, Renderable, 1);
-    Theme *theme = &themes[currentThemeIndex];
+    const GameState *state = ecs_singleton_get(it->world, GameState);
 
     for (int i = 0; i < it->count; i++) {
-        bool isSpacePressed = IsKeyDown(KEY_SPACE);
+        bool isSpacePressed = (state->input & INPUT_ATTRACT) != 0;
 
         // Handle activation/deactivation
         if (isSpacePressed && !vfx[i].wasActive) {
@@ -667,30 +275,12 @@ void AttractionRangeVFXSystem(ecs_iter_t *it) {
 
             // Draw attraction range circle with transparency
             if (vfx[i].currentRange > 0.1f) {
-                Color vfxColor;
-                switch (vfx[i].colorIndex) {
-                    case COLOR_BACKGROUND: vfxColor = theme->background;
-                        break;
-                    case COLOR_FOREGROUND: vfxColor = theme->foreground;
-                        break;
-                    case COLOR_CURSOR: vfxColor = theme->cursor_color;
-                        break;
-                    case COLOR_SELECTION: vfxColor = theme->selection_background;
-                        break;
-                    default:
-                        if (vfx[i].colorIndex >= COLOR_PALETTE_0 && vfx[i].colorIndex <= COLOR_PALETTE_15) {
-                            vfxColor = theme->palette[vfx[i].colorIndex];
-                        } else {
-                            vfxColor = WHITE;
-                        }
-                        break;
-                }
-                vfxColor.a = 50; // Set transparency
-                DrawCircleLines(renderable[i].position.x, renderable[i].position.y, vfx[i].currentRange, vfxColor);
+                const Vector2 center = WorldToScreen(state, renderable[i].position);
+                const float range = vfx[i].currentRange * state->zoom;
 
-                // Draw filled circle with even more transparency
-                vfxColor.a = 20;
-                DrawCircle(renderable[i].position.x, renderable[i].position.y, vfx[i].currentRange, vfxColor);
+                // Transparent outline over an even more transparent fill
+                render_circle(g_render, RENDER_LAYER_VFX, RENDER_OUTLINE, vfx[i].colorIndex, center, range, 50);
+                render_circle(g_render, RENDER_LAYER_VFX, RENDER_FILL, vfx[i].colorIndex, center, range, 20);
             }
         }
 
@@ -698,47 +288,105 @@ void AttractionRangeVFXSystem(ecs_iter_t *it) {
     }
 }
 
-void DrawBackgroundGrid(ecs_world_t *world) {
-    GameState *state = ecs_singleton_get(world, GameState);
-    const float zoom = state->zoom;
-    const Vector2 screenCenter = {
-        .x = GetScreenWidth() * 0.5f,
-        .y = GetScreenHeight() * 0.5f
-    };
-    Theme *theme = &themes[currentThemeIndex];
+// Background grid: a periodic dot pattern rendered once into a texture one grid
+// period larger than the screen on every side, then drawn each frame shifted by
+// the camera's offset within a period. Only zoom, screen size and theme change it.
+#define GRID_SPACING 50.0f
 
-    int screenWidth = GetScreenWidth();
-    int screenHeight = GetScreenHeight();
-
-    float gridSpacing = 50.0f; // Base grid spacing
+typedef struct {
+    RenderTexture2D texture;
+    RenderCommandBuffer dots;
+    float zoom;
+    int screenWidth;
+    int screenHeight;
+    int themeIndex;
+    float margin; // Screen pixels of pattern beyond each screen edge
+} GridLayer;
+
+static GridLayer g_grid;
+
+static void RenderGridLayer(const Theme *theme, float zoom, int screenWidth, int screenHeight) {
+    PROFILE_ZONE("RenderGridLayer");
+    const float period = GRID_SPACING * zoom;
+    const float margin = ceilf(period);
+    const Vector2 layerSize = {screenWidth + 2 * margin, screenHeight + 2 * margin};
+
+    // Texture in physical pixels so dots stay sharp on high DPI displays
+    const Vector2 dpi = GetWindowScaleDPI();
+    const int textureWidth = (int) ceilf(layerSize.x * dpi.x);
+    const int textureHeight = (int) ceilf(layerSize.y * dpi.y);
+    if (g_grid.texture.id == 0 || g_grid.texture.texture.width != textureWidth ||
+        g_grid.texture.texture.height != textureHeight) {
+        if (g_grid.texture.id != 0) UnloadRenderTexture(g_grid.texture);
+        g_grid.texture = LoadRenderTexture(textureWidth, textureHeight);
+    }
 
-    Color gridColor = theme->foreground;
-    gridColor.a = 30;
+    // Dots are opaque here; the 30 alpha of the grid is applied when compositing
+    Color palette[RENDER_PALETTE_SIZE];
+    ThemePalette(theme, palette);
+    render_commands_begin(&g_grid.dots, palette);
+
+    // Lattice through the screen center, like the world grid with the camera on a grid point
+    const Vector2 origin = {margin + screenWidth / 2.0f, margin + screenHeight / 2.0f};
+    const int firstX = -(int) ceilf(origin.x / period);
+    const int lastX = (int) ceilf((layerSize.x - origin.x) / period);
+    const int firstY = -(int) ceilf(origin.y / period);
+    const int lastY = (int) ceilf((layerSize.y - origin.y) / period);
+    for (int i = firstX; i <= lastX; i++) {
+        for (int j = firstY; j <= lastY; j++) {
+            const Vector2 dot = {(origin.x + i * period) * dpi.x, (origin.y + j * period) * dpi.y};
+            render_circle(&g_grid.dots, RENDER_LAYER_BODIES, RENDER_FILL, COLOR_FOREGROUND, dot, 2.0f * dpi.x, 255);
+        }
+    }
 
-    // Calculate how many grid lines we need based on unscaled spacing
-    int countX = (int) (screenWidth / (gridSpacing * zoom)) + 2;
-    int countY = (int) (screenHeight / (gridSpacing * zoom)) + 2;
+    BeginTextureMode(g_grid.texture);
+    ClearBackground(BLANK);
+    render_commands_submit(&g_grid.dots);
+    EndTextureMode();
 
-    // Draw grid dots
-    for (int i = -countX / 2; i <= countX / 2; i++) {
-        for (int j = -countY / 2; j <= countY / 2; j++) {
-            // Offset in world space (not screen space)
-            Vector2 offset = {i * gridSpacing, j * gridSpacing};
+    g_grid.zoom = zoom;
+    g_grid.screenWidth = screenWidth;
+    g_grid.screenHeight = screenHeight;
+    g_grid.themeIndex = currentThemeIndex;
+    g_grid.margin = margin;
+}
 
-            // Scale the offset and add to screen center
-            Vector2 scaledOffset = Vector2Scale(offset, zoom);
-            Vector2 screenPos = Vector2Add(screenCenter, scaledOffset);
+void DrawBackgroundGrid(const FrameSnapshot *frame) {
+    PROFILE_ZONE("DrawBackgroundGrid");
+    const float zoom = frame->zoom;
+    const int screenWidth = GetScreenWidth();
+    const int screenHeight = GetScreenHeight();
 
-            // Only draw if on screen
-            if (screenPos.x >= 0 && screenPos.x < screenWidth &&
-                screenPos.y >= 0 && screenPos.y < screenHeight) {
-                DrawCircle((int) screenPos.x, (int) screenPos.y, 2.0f, gridColor);
-            }
-        }
+    if (g_grid.texture.id == 0 || g_grid.zoom != zoom || g_grid.screenWidth != screenWidth ||
+        g_grid.screenHeight != screenHeight || g_grid.themeIndex != currentThemeIndex) {
+        RenderGridLayer(&themes[currentThemeIndex], zoom, screenWidth, screenHeight);
     }
+
+    // Dots sit on fixed world positions, so they scroll as the camera moves.
+    // Without a fixed world the camera is the screen center, itself a grid point.
+    const Vector2 anchor = frame->worldWidth > 0
+                               ? (Vector2){roundf(frame->camera.x / GRID_SPACING) * GRID_SPACING,
+                                           roundf(frame->camera.y / GRID_SPACING) * GRID_SPACING}
+                               : frame->camera;
+    const Vector2 offset = Vector2Scale(Vector2Subtract(anchor, frame->camera), zoom);
+
+    // Render textures are stored upside down, hence the negative source height
+    const Texture2D texture = g_grid.texture.texture;
+    const float margin = g_grid.margin;
+    DrawTexturePro(texture, (Rectangle){0, 0, (float) texture.width, (float) -texture.height},
+                   (Rectangle){offset.x - margin, offset.y - margin,
+                               screenWidth + 2 * margin, screenHeight + 2 * margin},
+                   (Vector2){0, 0}, 0.0f, (Color){255, 255, 255, 30});
 }
 
-void DrawUI(ecs_world_t *world) {
+static void FreeGridLayer(void) {
+    if (g_grid.texture.id != 0) UnloadRenderTexture(g_grid.texture);
+    render_commands_free(&g_grid.dots);
+    g_grid = (GridLayer){0};
+}
+
+void DrawUI(const FrameSnapshot *frame) {
+    PROFILE_ZONE("DrawUI");
     Theme *theme = &themes[currentThemeIndex];
 
     const int fontSize = 20;
@@ -749,14 +397,21 @@ void DrawUI(ecs_world_t *world) {
     DrawText(theme->name, margin, y, fontSize, theme->foreground);
 
     // Draw Physics
-    GameState *state = ecs_singleton_get(world, GameState);
-    DrawText(state->physics == REPEL ? "Repel" : "Attract", margin, y + 20, fontSize, theme->foreground);
+    static const char *PHYSICS_NAMES[PHYSICS_COUNT] = {"Repel", "Attract", "N-Body", "Flock"};
+    DrawText(PHYSICS_NAMES[frame->physics], margin, y + 20, fontSize, theme->foreground);
 
     // Enemy count
-    int enemyCount = ecs_count(world, EnemyInput);
-    const char *enemyText = TextFormat("%d", enemyCount);
+    const char *enemyText = frame->sleepingBodies > 0
+                                ? TextFormat("%d (%d asleep)", frame->enemyCount, frame->sleepingBodies)
+                                : TextFormat("%d", frame->enemyCount);
     DrawText(enemyText, margin, y + 40, fontSize, theme->foreground);
 
+    // Sector streaming
+    if (frame->worldWidth > 0) {
+        DrawText(TextFormat("%d sectors active, %d frozen", frame->activeSectors, frame->frozenBodies),
+                 margin, y + 60, fontSize, theme->foreground);
+    }
+
     // Draw FPS
     static int fps = 0;
     static float fpsTimer = 0.0f;
@@ -775,53 +430,262 @@ void DrawUI(ecs_world_t *world) {
     DrawText(fpsText, GetScreenWidth() - fpsWidth - margin, y, fontSize, theme->foreground);
 }
 
-void SpawnEnemy(ecs_world_t *world, Vector2 position) {
-    const ecs_entity_t enemy = ecs_new(world);
-
-    const float targetRadius = 15;
-
-    ecs_set(world, enemy, Health, {.health = 100});
-    ecs_set(world, enemy, Renderable, {.position = position, .radius = targetRadius * 0.3f,
-            .colorIndex = COLOR_PALETTE_2});
-    ecs_set(world, enemy, Velocity, {.velocity ={0, 0}});
-    ecs_set(world, enemy, EnemyInput, {.directionSet = false});
-    ecs_set(world, enemy, SpringAnimation, {
-            .currentRadius = targetRadius * 0.3f,
-            .targetRadius = targetRadius,
-            .velocity = 0,
-            .damping = 0.00001f,
-            .stiffness = 700.0f
-            });
-    ecs_set(world, enemy, Mortal, {});
-
-    PlayEnemySpawnSound();
+// Per-zone ms of the last frame next to the worst frame since the overlay was opened
+static int DrawZones(const ProfilerFrame *last, const ProfilerFrame *worst, int x, int y, int fontSize,
+                     int lineHeight, Color color) {
+    DrawText(TextFormat("%-26s %7s %7s", "zone", "ms", "worst"), x, y, fontSize, color);
+    y += lineHeight;
+    DrawText(TextFormat("%-26s %7.2f %7.2f", "frame", last->frame_ms, worst->frame_ms), x, y, fontSize, color);
+    y += lineHeight;
+
+    for (int i = 0; i < last->zone_count; i++) {
+        const ProfilerZoneStats *zone = &last->zones[i];
+        double worstMs = 0;
+        for (int w = 0; w < worst->zone_count; w++) {
+            if (worst->zones[w].name == zone->name) worstMs = worst->zones[w].ms;
+        }
+        DrawText(TextFormat("%-26s %7.2f %7.2f", zone->name, zone->ms, worstMs), x, y, fontSize, color);
+        y += lineHeight;
+    }
+    DrawText(TextFormat("T: write last %d frames to profile_trace.json", PROFILER_TRACE_FRAMES),
+             x, y, fontSize, color);
+    return y + lineHeight;
 }
 
-void HandleInput(ecs_world_t *world) {
-    if (IsKeyPressed(KEY_TAB)) {
-        ApplyTheme(currentThemeIndex + 1);
+// Live and peak bytes and last frame's allocations per subsystem
+static int DrawMemory(int x, int y, int fontSize, int lineHeight, Color color) {
+    DrawText(TextFormat("%-14s %9s %9s %9s", "memory", "live KB", "peak KB", "allocs/f"), x, y, fontSize, color);
+    y += lineHeight;
+
+    for (int tag = 0; tag < MEMTRACK_TAG_COUNT; tag++) {
+        const MemTagStats stats = memtrack_stats((MemTag) tag);
+        DrawText(TextFormat("%-14s %9.1f %9.1f %9lld", MEMTRACK_TAG_NAMES[tag], stats.live_bytes / 1024.0,
+                            stats.peak_bytes / 1024.0, stats.last_frame_allocs),
+                 x, y, fontSize, color);
+        y += lineHeight;
     }
 
-    if (IsKeyDown(KEY_E)) {
-        Vector2 spawnPos = {
-            (float) GetRandomValue(50, GetScreenWidth() - 50),
-            (float) GetRandomValue(50, GetScreenHeight() - 50)
-        };
-        SpawnEnemy(world, spawnPos);
+    const MemTagStats total = memtrack_total();
+    DrawText(TextFormat("%-14s %9.1f %9s %9lld", "total", total.live_bytes / 1024.0, "", total.last_frame_allocs),
+             x, y, fontSize, color);
+    return y + lineHeight;
+}
+
+// Debug overlay: profiler zones (when built with the profiler) and memory
+void DrawProfiler(void) {
+    const ProfilerFrame *last = profiler_last_frame();
+    const ProfilerFrame *worst = profiler_worst_frame();
+
+    Theme *theme = &themes[currentThemeIndex];
+    const int fontSize = 10;
+    const int lineHeight = 12;
+    const int x = GetScreenWidth() - 330;
+    int y = 40;
+
+    const int zoneLines = last ? last->zone_count + 3 : 0;
+    const int memoryLines = MEMTRACK_TAG_COUNT + 2;
+    Color panel = theme->background;
+    panel.a = 200;
+    DrawRectangle(x - 10, y - 5, 330, (zoneLines + memoryLines) * lineHeight + 10, panel);
+
+    if (last && worst) {
+        y = DrawZones(last, worst, x, y, fontSize, lineHeight, theme->foreground);
     }
+    DrawMemory(x, y, fontSize, lineHeight, theme->foreground);
+}
 
-    if (IsKeyPressed(KEY_F)) {
-        GameState *state = ecs_singleton_get_mut(world, GameState);
-        state->physics = (state->physics + 1) % PHYSICS_COUNT;
+// Handle presentation-only keys and collect the simulation's input for this frame
+TickInput HandleInput(void) {
+    if (IsKeyPressed(KEY_TAB)) {
+        ApplyTheme(currentThemeIndex + 1);
     }
 
     if (IsKeyPressed(KEY_D)) {
         g_debug_spatial = !g_debug_spatial;
         printf("Spatial debug: %s\n", g_debug_spatial ? "ON" : "OFF");
     }
+
+    if (IsKeyPressed(KEY_P)) {
+        g_show_profiler = !g_show_profiler;
+        profiler_reset_worst();
+    }
+
+    if (IsKeyPressed(KEY_T) && profiler_write_trace("profile_trace.json", PROFILER_TRACE_FRAMES)) {
+        printf("Wrote profile_trace.json\n");
+    }
+
+    if (IsKeyDown(KEY_R)) g_sim_requests |= SIM_REQUEST_REWIND;
+    if (IsKeyPressed(KEY_F5)) g_sim_requests |= SIM_REQUEST_SAVE;
+    if (IsKeyPressed(KEY_F9)) g_sim_requests |= SIM_REQUEST_LOAD;
+
+    TickInput input = {
+        .buttons = 0,
+        .dt = GetFrameTime(),
+        .screenWidth = GetScreenWidth(),
+        .screenHeight = GetScreenHeight()
+    };
+
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= INPUT_RIGHT;
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= INPUT_LEFT;
+    if (IsKeyDown(KEY_UP)) input.buttons |= INPUT_UP;
+    if (IsKeyDown(KEY_DOWN)) input.buttons |= INPUT_DOWN;
+    if (IsKeyDown(KEY_SPACE)) input.buttons |= INPUT_ATTRACT;
+    if (IsKeyDown(KEY_E)) input.buttons |= INPUT_SPAWN;
+    if (IsKeyPressed(KEY_F)) input.buttons |= INPUT_CYCLE_PHYSICS;
+    if (IsKeyPressed(KEY_W)) input.buttons |= INPUT_SPAWN_WAVE;
+
+    return input;
+}
+
+// The simulation side of a frame: tick the world and capture what the renderer needs
+typedef struct {
+    ecs_world_t *world;
+    ReplayWriter *recorder;
+    ecs_entity_t renderSystem; // Records a restored frame without ticking
+    RewindBuffer rewind;       // Past frames, with --rewind
+    WorldSnapshot state;       // Capture storage for saves and the rewind buffer
+} Simulation;
+
+// Resolved from the theme when the snapshot is drawn
+static const Color UNRESOLVED_PALETTE[RENDER_PALETTE_SIZE];
+
+// Keep the current state as the newest rewind frame
+static void PushRewindFrame(Simulation *simulation) {
+    if (simulation->rewind.max_steps == 0) return;
+
+    PROFILE_ZONE("RewindPush");
+    if (!SnapshotCapture(simulation->world, &simulation->state) ||
+        !rewind_push(&simulation->rewind, simulation->state.data, simulation->state.size)) {
+        printf("Error: Out of memory for the rewind buffer\n");
+    }
+}
+
+// Serve save, load and rewind requests. Returns true if the world was restored,
+// in which case this frame shows the restored state instead of a tick.
+static bool ServeRequests(Simulation *simulation, unsigned int requests) {
+    ecs_world_t *world = simulation->world;
+
+    if (requests & SIM_REQUEST_SAVE) {
+        if (SnapshotCapture(world, &simulation->state) && SnapshotSave(&simulation->state, SAVE_STATE_PATH)) {
+            printf("Saved state to %s (%zu bytes)\n", SAVE_STATE_PATH, simulation->state.size);
+        }
+    }
+
+    // A recording only holds inputs, so it can't follow the world back in time
+    if (simulation->recorder->file) return false;
+
+    if (requests & SIM_REQUEST_LOAD) {
+        WorldSnapshot saved = {0};
+        const bool loaded = SnapshotLoad(&saved, SAVE_STATE_PATH) && SnapshotRestore(world, &saved);
+        SnapshotFree(&saved);
+        if (!loaded) {
+            printf("Error: %s is not a save state of this build and world\n", SAVE_STATE_PATH);
+            return false;
+        }
+        printf("Loaded state from %s\n", SAVE_STATE_PATH);
+        PushRewindFrame(simulation);
+        return true;
+    }
+
+    if ((requests & SIM_REQUEST_REWIND) && rewind_step_back(&simulation->rewind)) {
+        const WorldSnapshot previous = {
+            .data = simulation->rewind.head.data,
+            .size = simulation->rewind.head.size
+        };
+        return SnapshotRestore(world, &previous);
+    }
+    return false;
+}
+
+void SimulateFrame(Simulation *simulation, const TickInput *input, FrameSnapshot *frame) {
+    ecs_world_t *world = simulation->world;
+    g_render = &frame->commands;
+    render_commands_begin(g_render, UNRESOLVED_PALETTE);
+
+    if (ServeRequests(simulation, atomic_exchange(&g_sim_requests, 0))) {
+        // Draw the restored bodies as they are
+        ecs_run(world, simulation->renderSystem, 0, NULL);
+        frame_scratch_swap();
+    } else {
+        PROFILE_BEGIN("GameTick");
+        GameTick(world, input);
+        PROFILE_END();
+
+        if (simulation->recorder->file) {
+            ReplayWriterTick(simulation->recorder, input, GameStateHash(world));
+        }
+        PushRewindFrame(simulation);
+    }
+
+    const GameState *state = ecs_singleton_get(world, GameState);
+    frame->camera = state->camera;
+    frame->zoom = state->zoom;
+    frame->physics = state->physics;
+    frame->enemyCount = ecs_count(world, EnemyInput);
+    frame->sleepingBodies = state->sleepingBodies;
+    frame->worldWidth = state->worldWidth;
+    frame->activeSectors = state->activeSectors;
+    frame->frozenBodies = state->frozenBodies;
+    quadtree_debug_capture(g_debug_spatial ? g_quadtree : NULL, &frame->quadtree);
+}
+
+// Draw a simulated frame (between BeginDrawing and EndDrawing)
+void DrawFrame(FrameSnapshot *frame) {
+    DrawBackgroundGrid(frame);
+
+    ThemePalette(&themes[currentThemeIndex], frame->commands.palette);
+    render_commands_submit(&frame->commands);
+
+    // Spatial partitioning debug visualization, with the camera transform of WorldToScreen
+    if (frame->quadtree.count > 0) {
+        PROFILE_ZONE("QuadtreeDebugDraw");
+        const Vector2 screenCenter = {GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f};
+        quadtree_debug_draw_snapshot(&frame->quadtree, frame->camera, screenCenter, frame->zoom);
+    }
+
+    DrawUI(frame);
+}
+
+// Pipelined mode: the simulation thread owns the world and the job workers
+static void SimulationStart(void *user) {
+    (void) user;
+    jobs_init(-1);
+}
+
+static void SimulationStop(void *user) {
+    (void) user;
+    jobs_shutdown();
 }
 
-int main(void) {
+static void SimulationStep(const TickInput *input, int slot, void *user) {
+    SimulateFrame(user, input, &g_snapshots[slot]);
+}
+
+int main(int argc, char **argv) {
+    // Command line: --record <file> logs every tick for replay with sim_bench --replay,
+    // --world <w> <h> plays in a fixed world streamed in sectors instead of the screen,
+    // --pipelined simulates the next frame on its own thread while this one is drawn,
+    // --rewind <frames> keeps that many past frames to step back through (R)
+    const char *recordPath = NULL;
+    unsigned int seed = (unsigned int) time(NULL);
+    float worldWidth = 0, worldHeight = 0;
+    bool pipelined = false;
+    int rewindFrames = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--world") == 0 && i + 2 < argc) {
+            worldWidth = strtof(argv[++i], NULL);
+            worldHeight = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pipelined") == 0) {
+            pipelined = true;
+        } else if (strcmp(argv[i], "--rewind") == 0 && i + 1 < argc) {
+            rewindFrames = atoi(argv[++i]);
+        }
+    }
+
     SetConfigFlags(FLAG_WINDOW_HIGHDPI); // Enable high DPI support
     InitWindow(1280, 720, "raylib window");
     // SetTargetFPS(120);
@@ -840,88 +704,99 @@ int main(void) {
         ApplyTheme(0);
     }
 
+    // Before anything allocates, so flecs and the quadtree are accounted from the start
+    GameInstallMemoryTracking();
+
+    // Worker threads for simulation jobs; the thread running the simulation is worker 0
+    if (!pipelined) {
+        jobs_init(-1);
+    }
+
     ecs_world_t *world = ecs_init();
 
-    ECS_COMPONENT_DEFINE(world, Health);
-    ECS_COMPONENT_DEFINE(world, Velocity);
-    ECS_COMPONENT_DEFINE(world, PlayerInput);
-    ECS_COMPONENT_DEFINE(world, EnemyInput);
-    ECS_COMPONENT_DEFINE(world, Renderable);
-    ECS_COMPONENT_DEFINE(world, SpringAnimation);
-    ECS_COMPONENT_DEFINE(world, AttractionRangeVFX);
-    ECS_COMPONENT_DEFINE(world, Spike);
-    ECS_COMPONENT_DEFINE(world, Mortal);
-    ECS_COMPONENT_DEFINE(world, GameState);
-
-    ecs_singleton_set(world, GameState, {
-                      .physics = REPEL,
-                      .zoom = 1.0f,
-                      .targetZoom = 1.0f
-                      });
-
-    ECS_SYSTEM(world, PlayerMovementSystem, EcsOnUpdate, Velocity, PlayerInput);
-    ECS_SYSTEM(world, EnemyMovementSystem, EcsOnUpdate, Velocity, EnemyInput, Renderable);
-    ECS_SYSTEM(world, GlobalPositionUpdateSystem, EcsOnUpdate);
-    ECS_SYSTEM(world, SpringAnimationSystem, EcsOnUpdate, SpringAnimation, Renderable);
-    ECS_SYSTEM(world, AttractionRangeVFXSystem, EcsOnUpdate, AttractionRangeVFX, Renderable);
-    ECS_SYSTEM(world, RenderSystem, EcsOnUpdate, Renderable);
-
-    ecs_entity_t player = ecs_new(world);
-    ecs_set_name(world, player, "Player"); // {}
-    ecs_set(world, player, Health, {.health = 100});
-    ecs_set(world, player, Renderable, {
-            .position = {GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f},
-            .radius = 20,
-            .colorIndex = COLOR_FOREGROUND
-            });
-    ecs_set(world, player, Velocity, {.velocity ={0, 0}});
-    ecs_set(world, player, PlayerInput, {});
-    ecs_set(world, player, AttractionRangeVFX, {
-            .range = (float)MIN(GetScreenWidth(), GetScreenHeight()) / 2,
-            // Match MAX_ATTRACTION_RANGE from EnemyMovementSystem
-            .currentRange = 0,
-            .targetRange = 0,
-            .velocity = 0,
-            .damping = 0.95f,
-            .stiffness = 0.01f,
-            .colorIndex = COLOR_PALETTE_4,
-            .active = true,
-            .wasActive = false
-            });
-    ecs_set(world, player, Spike, {});
+    GameInit(world, GetScreenWidth(), GetScreenHeight(), seed);
+    if (worldWidth > 0 && worldHeight > 0) {
+        GameSetWorldSize(world, worldWidth, worldHeight);
+    }
 
-    while (!WindowShouldClose()) {
-        BeginDrawing();
+    // Presentation systems run after the simulation systems registered by GameInit
+    ECS_SYSTEM(world, AttractionRangeVFXSystem, EcsOnUpdate, AttractionRangeVFX, Renderable);
+    ECS_SYSTEM(world, RenderSystem, EcsOnUpdate);
 
-        Theme *theme = &themes[currentThemeIndex];
-        ClearBackground(theme->background);
+    SpawnPlayer(world);
 
-        DrawBackgroundGrid(world);
+    ReplayWriter recorder = {0};
+    if (recordPath && ReplayWriterOpen(&recorder, recordPath, seed, GetScreenWidth(), GetScreenHeight(),
+                                      worldWidth, worldHeight)) {
+        printf("Recording to %s (seed %u)\n", recordPath, seed);
+    }
 
-        HandleInput(world);
+    Simulation simulation = {.world = world, .recorder = &recorder, .renderSystem = RenderSystem};
+    if (!rewind_init(&simulation.rewind, rewindFrames)) {
+        printf("Error: Cannot allocate a rewind buffer of %d frames\n", rewindFrames);
+    }
+    SimPipeline pipeline = {0};
+    if (pipelined && !sim_pipeline_start(&pipeline, (SimPipelineStage){
+                                         .start = SimulationStart,
+                                         .stop = SimulationStop,
+                                         .step = SimulationStep,
+                                         .user = &simulation
+                                     })) {
+        printf("Error: Cannot start the simulation thread, simulating on the main thread\n");
+        pipelined = false;
+        jobs_init(-1);
+    }
 
-        ecs_progress(world, GetFrameTime());
+    while (!WindowShouldClose()) {
+        TickInput input = HandleInput();
 
-        // Draw spatial partitioning debug visualization
-        if (g_debug_spatial && g_quadtree) {
-            GameState *state = ecs_singleton_get(world, GameState);
-            Vector2 screenCenter = {GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f};
-            // Pass screen center as camera offset so debug viz uses same transform as entities
-            quadtree_debug_draw(g_quadtree, screenCenter, state->zoom);
+        BeginDrawing();
+        ClearBackground(themes[currentThemeIndex].background);
+
+        if (pipelined) {
+            // Draw the previous frame while the simulation works on this one
+            sim_pipeline_submit(&pipeline, &input);
+            const int slot = sim_pipeline_acquire(&pipeline);
+            if (slot >= 0) {
+                DrawFrame(&g_snapshots[slot]);
+            }
+            sim_pipeline_release(&pipeline, slot);
+        } else {
+            SimulateFrame(&simulation, &input, &g_snapshots[0]);
+            DrawFrame(&g_snapshots[0]);
         }
 
-        DrawUI(world);
+        if (g_show_profiler) {
+            DrawProfiler();
+        }
 
+        PROFILE_BEGIN("EndDrawing");
         EndDrawing();
+        PROFILE_END();
+
+        profiler_frame_end();
+        memtrack_frame_end();
+    }
+
+    // Stops the job workers too, when pipelined
+    sim_pipeline_stop(&pipeline);
+
+    if (recorder.file) {
+        printf("Recorded %d ticks\n", recorder.tickCount);
+        ReplayWriterClose(&recorder);
     }
 
-    // Cleanup spatial partitioning
-    if (g_quadtree) {
-        quadtree_destroy(g_quadtree);
-        g_quadtree = NULL;
+    rewind_free(&simulation.rewind);
+    SnapshotFree(&simulation.state);
+    GameShutdown();
+    for (int i = 0; i < SIM_PIPELINE_SLOTS; i++) {
+        render_commands_free(&g_snapshots[i].commands);
+        quadtree_debug_snapshot_free(&g_snapshots[i].quadtree);
     }
+    FreeGridLayer();
 
     ecs_fini(world);
+    jobs_shutdown();
     CleanupAudio();
     CloseWindow();
 
@@ -0,0 +1,127 @@
+#include "memtrack.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+const char* MEMTRACK_TAG_NAMES[MEMTRACK_TAG_COUNT] = {
+    "flecs", "spatial", "neighbors", "contacts", "physics", "sectors", "jobs", "profiler", "scratch", "render",
+    "snapshot", "animation"
+};
+
+// Prepended to every block; padded so the user pointer keeps malloc's alignment
+typedef union {
+    struct {
+        size_t size;
+        MemTag tag;
+    } info;
+    max_align_t align;
+} BlockHeader;
+
+typedef struct {
+    atomic_llong live_bytes;
+    atomic_llong peak_bytes;
+    atomic_llong allocs;
+    atomic_llong frees;
+    atomic_llong frame_allocs;
+    long long last_frame_allocs;
+} TagCounters;
+
+static TagCounters g_counters[MEMTRACK_TAG_COUNT];
+
+static void count_alloc(MemTag tag, long long bytes) {
+    TagCounters* c = &g_counters[tag];
+    atomic_fetch_add_explicit(&c->allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->frame_allocs, 1, memory_order_relaxed);
+
+    const long long live = atomic_fetch_add_explicit(&c->live_bytes, bytes, memory_order_relaxed) + bytes;
+    long long peak = atomic_load_explicit(&c->peak_bytes, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&c->peak_bytes, &peak, live,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void count_free(MemTag tag, long long bytes) {
+    atomic_fetch_add_explicit(&g_counters[tag].frees, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&g_counters[tag].live_bytes, bytes, memory_order_relaxed);
+}
+
+// === Allocation ===
+
+void* memtrack_alloc(MemTag tag, size_t size) {
+    BlockHeader* header = malloc(sizeof(BlockHeader) + size);
+    if (!header) return NULL;
+
+    header->info.size = size;
+    header->info.tag = tag;
+    count_alloc(tag, (long long)size);
+    return header + 1;
+}
+
+void* memtrack_calloc(MemTag tag, size_t count, size_t size) {
+    if (size && count > ((size_t)-1 - sizeof(BlockHeader)) / size) return NULL;
+
+    void* ptr = memtrack_alloc(tag, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* memtrack_realloc(MemTag tag, void* ptr, size_t size) {
+    if (!ptr) return memtrack_alloc(tag, size);
+    if (size == 0) {
+        memtrack_free(ptr);
+        return NULL;
+    }
+
+    BlockHeader* header = (BlockHeader*)ptr - 1;
+    const size_t old_size = header->info.size;
+    const MemTag owner = header->info.tag;
+
+    BlockHeader* moved = realloc(header, sizeof(BlockHeader) + size);
+    if (!moved) return NULL;
+
+    moved->info.size = size;
+    count_free(owner, (long long)old_size);
+    count_alloc(owner, (long long)size);
+    return moved + 1;
+}
+
+void memtrack_free(void* ptr) {
+    if (!ptr) return;
+
+    BlockHeader* header = (BlockHeader*)ptr - 1;
+    count_free(header->info.tag, (long long)header->info.size);
+    free(header);
+}
+
+// === Statistics ===
+
+MemTagStats memtrack_stats(MemTag tag) {
+    const TagCounters* c = &g_counters[tag];
+    return (MemTagStats){
+        .live_bytes = atomic_load(&c->live_bytes),
+        .peak_bytes = atomic_load(&c->peak_bytes),
+        .allocs = atomic_load(&c->allocs),
+        .frees = atomic_load(&c->frees),
+        .last_frame_allocs = c->last_frame_allocs
+    };
+}
+
+MemTagStats memtrack_total(void) {
+    MemTagStats total = {0};
+    for (int tag = 0; tag < MEMTRACK_TAG_COUNT; tag++) {
+        const MemTagStats s = memtrack_stats((MemTag)tag);
+        total.live_bytes += s.live_bytes;
+        total.peak_bytes += s.peak_bytes; // Sum of per-tag peaks: an upper bound
+        total.allocs += s.allocs;
+        total.frees += s.frees;
+        total.last_frame_allocs += s.last_frame_allocs;
+    }
+    return total;
+}
+
+void memtrack_frame_end(void) {
+    for (int tag = 0; tag < MEMTRACK_TAG_COUNT; tag++) {
+        g_counters[tag].last_frame_allocs = atomic_exchange(&g_counters[tag].frame_allocs, 0);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stddef.h>
+
+// Tracking allocator: every allocation is tagged with the subsystem that owns it,
+// and per-tag live bytes, high-water marks and allocation counts are kept.
+//
+// Each block carries a small header with its size and tag, so memtrack_free and
+// memtrack_realloc don't need to be told either. Memory from memtrack_* must only
+// be released through memtrack_* (and the other way around for malloc/free).
+// Counters are atomic, so any thread may allocate.
+
+typedef enum {
+    MEMTRACK_FLECS,     // ECS storage, through the flecs OS API hooks
+    MEMTRACK_SPATIAL,   // Quadtree nodes and scratch
+    MEMTRACK_NEIGHBORS, // Neighbor lists
+    MEMTRACK_CONTACTS,  // Contact table and events
+    MEMTRACK_PHYSICS,   // Physics body arrays
+    MEMTRACK_SECTORS,   // Frozen bodies of dormant sectors
+    MEMTRACK_JOBS,      // Job deques and continuations
+    MEMTRACK_PROFILER,  // Zone ring buffers
+    MEMTRACK_SCRATCH,   // Frame scratch arenas
+    MEMTRACK_RENDER,    // Draw command buffers
+    MEMTRACK_SNAPSHOT,  // World snapshots and the rewind buffer
+    MEMTRACK_ANIMATION, // Tween pool
+    MEMTRACK_TAG_COUNT
+} MemTag;
+
+typedef struct {
+    long long live_bytes;
+    long long peak_bytes;        // Highest live_bytes so far
+    long long allocs;            // Allocations so far, including every realloc
+    long long frees;
+    long long last_frame_allocs; // Allocations during the last frame (see memtrack_frame_end)
+} MemTagStats;
+
+extern const char* MEMTRACK_TAG_NAMES[MEMTRACK_TAG_COUNT];
+
+// === Allocation ===
+
+void* memtrack_alloc(MemTag tag, size_t size);
+void* memtrack_calloc(MemTag tag, size_t count, size_t size);
+
+// ptr NULL allocates; size 0 frees and returns NULL. The block keeps its original tag.
+void* memtrack_realloc(MemTag tag, void* ptr, size_t size);
+
+void memtrack_free(void* ptr);
+
+// === Statistics ===
+
+MemTagStats memtrack_stats(MemTag tag);
+
+// Sum over all tags
+MemTagStats memtrack_total(void);
+
+// Close a frame: latch each tag's allocation count since the previous call
+void memtrack_frame_end(void);
+
+#endif // MEMTRACK_H
@@ -0,0 +1,87 @@
+#include "neighbors.h"
+#include "memtrack.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef struct {
+    NeighborList* list;
+    int body;
+} AppendContext;
+
+static void ensure_index_capacity(NeighborList* list, int needed) {
+    if (needed <= list->index_capacity) return;
+
+    int capacity = list->index_capacity ? list->index_capacity : 1024;
+    while (capacity < needed) capacity *= 2;
+
+    list->indices = memtrack_realloc(MEMTRACK_NEIGHBORS, list->indices, sizeof(int) * capacity);
+    list->index_capacity = capacity;
+}
+
+static void append_callback(int entity_index, void* user_data) {
+    AppendContext* ctx = user_data;
+    NeighborList* list = ctx->list;
+
+    // Entities spanning several leaves are reported once per leaf
+    if (entity_index == ctx->body || entity_index >= list->row_count ||
+        list->stamp[entity_index] == ctx->body + 1) {
+        return;
+    }
+    list->stamp[entity_index] = ctx->body + 1;
+
+    ensure_index_capacity(list, list->index_count + 1);
+    list->indices[list->index_count++] = entity_index;
+}
+
+void neighbor_list_free(NeighborList* list) {
+    memtrack_free(list->offsets);
+    memtrack_free(list->indices);
+    memtrack_free(list->anchors);
+    memtrack_free(list->stamp);
+    memset(list, 0, sizeof(*list));
+}
+
+void neighbor_list_begin(NeighborList* list, int body_count, float margin) {
+    if (body_count > list->row_capacity) {
+        list->offsets = memtrack_realloc(MEMTRACK_NEIGHBORS, list->offsets, sizeof(int) * (body_count + 1));
+        list->anchors = memtrack_realloc(MEMTRACK_NEIGHBORS, list->anchors, sizeof(NeighborAnchor) * body_count);
+        list->stamp = memtrack_realloc(MEMTRACK_NEIGHBORS, list->stamp, sizeof(int) * body_count);
+        list->row_capacity = body_count;
+    }
+
+    if (!list->offsets) {
+        list->offsets = memtrack_alloc(MEMTRACK_NEIGHBORS, sizeof(int));
+    }
+
+    if (body_count > 0) {
+        memset(list->stamp, 0, sizeof(int) * body_count);
+    }
+    list->row_count = body_count;
+    list->index_count = 0;
+    list->margin = margin;
+    list->offsets[0] = 0;
+}
+
+void neighbor_list_append(NeighborList* list, Quadtree* tree, int body, Vector2 position, float radius) {
+    neighbor_list_append_padded(list, tree, body, position, radius, 0.0f);
+}
+
+void neighbor_list_append_padded(NeighborList* list, Quadtree* tree, int body, Vector2 position, float radius,
+                                 float padding) {
+    AppendContext ctx = {list, body};
+    quadtree_query_callback(tree, aabb_from_circle(position, radius + list->margin + padding), append_callback, &ctx);
+    list->offsets[body + 1] = list->index_count;
+    list->anchors[body] = (NeighborAnchor){position, radius};
+}
+
+void neighbor_list_append_empty(NeighborList* list, int body) {
+    list->offsets[body + 1] = list->index_count;
+}
+
+float neighbor_list_drift(const NeighborList* list, int body, Vector2 position, float radius) {
+    const NeighborAnchor anchor = list->anchors[body];
+    const float dx = position.x - anchor.position.x;
+    const float dy = position.y - anchor.position.y;
+    return sqrtf(dx * dx + dy * dy) + fmaxf(radius - anchor.radius, 0.0f);
+}
@@ -0,0 +1,72 @@
+#ifndef NEIGHBORS_H
+#define NEIGHBORS_H
+
+#include "spatial.h"
+
+// Neighbor lists in CSR (compressed sparse row) form.
+// Row i lists every other body whose quadtree bounds intersect body i's circle
+// grown by the list margin, once each: indices[offsets[i]] .. indices[offsets[i + 1] - 1].
+// Built from the quadtree and shared by every consumer (collision, flocking)
+// so neighbor discovery is only paid for once.
+//
+// Lists can also be kept across frames (Verlet lists): a row stays complete for
+// every pair within radius + skin as long as no body drifts (moves, or grows)
+// by more than half the skin since the build.
+
+// Body state when its row was built
+typedef struct {
+    Vector2 position;
+    float radius;
+} NeighborAnchor;
+
+typedef struct {
+    int* offsets;          // row_count + 1 entries
+    int* indices;          // Neighbor indices of all rows, back to back
+    NeighborAnchor* anchors; // Per body, for neighbor_list_drift
+    int row_count;
+    int index_count;
+    int row_capacity;
+    int index_capacity;
+    float margin;          // Distance beyond both radii covered by every row
+    int* stamp;            // Scratch for de-duplicating quadtree results (row + 1 per body)
+} NeighborList;
+
+// === Lifecycle ===
+
+// Zero-initialized lists are valid; storage grows on demand and is kept for reuse
+void neighbor_list_free(NeighborList* list);
+
+// === Building ===
+
+// Start a new build for body_count bodies (indices 0 .. body_count - 1)
+void neighbor_list_begin(NeighborList* list, int body_count, float margin);
+
+// Append the next row: bodies in the tree whose bounds intersect the circle at
+// position with radius + margin, excluding body itself.
+// Rows must be appended in order 0, 1, 2, ...
+void neighbor_list_append(NeighborList* list, Quadtree* tree, int body, Vector2 position, float radius);
+
+// neighbor_list_append for a tree built from older positions: the query grows by
+// padding, the most any body has moved or grown since the tree was built
+void neighbor_list_append_padded(NeighborList* list, Quadtree* tree, int body, Vector2 position, float radius,
+                                 float padding);
+
+// Append an empty row for a body that won't look for neighbors this frame.
+// Empty rows have no anchor, so lists meant to be kept across frames can't use them.
+void neighbor_list_append_empty(NeighborList* list, int body);
+
+// === Access ===
+
+static inline int neighbor_list_count(const NeighborList* list, int body) {
+    return list->offsets[body + 1] - list->offsets[body];
+}
+
+static inline const int* neighbor_list_row(const NeighborList* list, int body) {
+    return list->indices + list->offsets[body];
+}
+
+// How far a body has drifted since its row was built: distance moved plus
+// radius growth. Rows stay valid while every body's drift is below half the skin.
+float neighbor_list_drift(const NeighborList* list, int body, Vector2 position, float radius);
+
+#endif // NEIGHBORS_H
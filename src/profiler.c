@@ -0,0 +1,215 @@
+#include "profiler.h"
+#include "memtrack.h"
+
+#ifdef PROFILER_ENABLED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+
+typedef struct {
+    const char* name;
+    unsigned long long start_ns;
+    unsigned long long end_ns;
+    int depth;
+} ZoneRecord;
+
+typedef struct {
+    // Written only by the owning thread
+    ZoneRecord records[PROFILER_RING_SIZE];
+    atomic_ullong written; // Records ever written; the ring holds the last PROFILER_RING_SIZE
+    const char* open_names[PROFILER_MAX_DEPTH];
+    unsigned long long open_starts[PROFILER_MAX_DEPTH];
+    int depth;
+
+    // Owned by the thread calling profiler_frame_end
+    unsigned long long read; // Records already aggregated
+} ProfilerThread;
+
+// A slot is claimed by bumping the count and filled afterwards, so readers
+// load each entry atomically and skip the ones still NULL
+static _Atomic(ProfilerThread*) g_threads[PROFILER_MAX_THREADS];
+static atomic_int g_thread_count;
+static _Thread_local ProfilerThread* t_thread;
+static _Thread_local bool t_unrecorded; // No slot or no memory: don't try again
+
+static unsigned long long g_frame_starts[PROFILER_MAX_FRAMES];
+static unsigned long long g_frame_count;
+static unsigned long long g_frame_start_ns;
+static ProfilerFrame g_last_frame;
+static ProfilerFrame g_worst_frame;
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+// Register the calling thread on its first zone. Threads beyond the limit aren't recorded.
+static ProfilerThread* thread_state(void) {
+    if (t_thread || t_unrecorded) return t_thread;
+
+    const int slot = atomic_fetch_add(&g_thread_count, 1);
+    ProfilerThread* thread = slot < PROFILER_MAX_THREADS
+        ? memtrack_calloc(MEMTRACK_PROFILER, 1, sizeof(ProfilerThread))
+        : NULL;
+    if (!thread) {
+        t_unrecorded = true;
+        return NULL;
+    }
+
+    atomic_store_explicit(&g_threads[slot], thread, memory_order_release);
+    t_thread = thread;
+    return thread;
+}
+
+static int thread_total(void) {
+    const int count = atomic_load(&g_thread_count);
+    return count < PROFILER_MAX_THREADS ? count : PROFILER_MAX_THREADS;
+}
+
+// === Recording ===
+
+void profiler_begin_zone(const char* name) {
+    ProfilerThread* thread = thread_state();
+    if (!thread) return;
+
+    if (thread->depth < PROFILER_MAX_DEPTH) {
+        thread->open_names[thread->depth] = name;
+        thread->open_starts[thread->depth] = now_ns();
+    }
+    thread->depth++;
+}
+
+void profiler_end_zone(void) {
+    ProfilerThread* thread = t_thread;
+    if (!thread || thread->depth == 0) return;
+
+    thread->depth--;
+    if (thread->depth >= PROFILER_MAX_DEPTH) return; // Too deep to have been recorded
+
+    const unsigned long long index = atomic_load_explicit(&thread->written, memory_order_relaxed);
+    ZoneRecord* record = &thread->records[index & (PROFILER_RING_SIZE - 1)];
+    record->name = thread->open_names[thread->depth];
+    record->start_ns = thread->open_starts[thread->depth];
+    record->end_ns = now_ns();
+    record->depth = thread->depth;
+
+    // Publish: readers only look at records below written
+    atomic_store_explicit(&thread->written, index + 1, memory_order_release);
+}
+
+// === Frames ===
+
+static void add_zone(ProfilerFrame* frame, const char* name, double ms) {
+    for (int i = 0; i < frame->zone_count; i++) {
+        if (frame->zones[i].name == name) {
+            frame->zones[i].ms += ms;
+            frame->zones[i].calls++;
+            return;
+        }
+    }
+
+    if (frame->zone_count < PROFILER_MAX_ZONES) {
+        frame->zones[frame->zone_count++] = (ProfilerZoneStats){name, ms, 1};
+    }
+}
+
+void profiler_frame_end(void) {
+    const unsigned long long now = now_ns();
+    if (g_frame_count == 0 && g_frame_start_ns == 0) {
+        // First call only starts the first frame
+        g_frame_start_ns = now;
+        g_frame_starts[0] = now;
+        return;
+    }
+
+    ProfilerFrame frame = {.frame_ms = (double)(now - g_frame_start_ns) / 1e6};
+
+    for (int t = 0; t < thread_total(); t++) {
+        ProfilerThread* thread = atomic_load_explicit(&g_threads[t], memory_order_acquire);
+        if (!thread) continue;
+
+        const unsigned long long written = atomic_load_explicit(&thread->written, memory_order_acquire);
+        unsigned long long read = thread->read;
+        if (written - read > PROFILER_RING_SIZE) {
+            read = written - PROFILER_RING_SIZE; // Overrun: the oldest records are gone
+        }
+
+        for (; read < written; read++) {
+            const ZoneRecord* record = &thread->records[read & (PROFILER_RING_SIZE - 1)];
+            add_zone(&frame, record->name, (double)(record->end_ns - record->start_ns) / 1e6);
+        }
+        thread->read = written;
+    }
+
+    g_last_frame = frame;
+    if (frame.frame_ms > g_worst_frame.frame_ms) {
+        g_worst_frame = frame;
+    }
+
+    g_frame_count++;
+    g_frame_start_ns = now;
+    g_frame_starts[g_frame_count % PROFILER_MAX_FRAMES] = now;
+}
+
+const ProfilerFrame* profiler_last_frame(void) {
+    return &g_last_frame;
+}
+
+const ProfilerFrame* profiler_worst_frame(void) {
+    return &g_worst_frame;
+}
+
+void profiler_reset_worst(void) {
+    memset(&g_worst_frame, 0, sizeof(g_worst_frame));
+}
+
+// === Chrome trace ===
+
+bool profiler_write_trace(const char* path, int frame_count) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Error: Cannot open trace file %s for writing\n", path);
+        return false;
+    }
+
+    // Oldest frame boundary still covered
+    if (frame_count > PROFILER_MAX_FRAMES - 1) frame_count = PROFILER_MAX_FRAMES - 1;
+    if ((unsigned long long)frame_count > g_frame_count) frame_count = (int)g_frame_count;
+    const unsigned long long since = g_frame_starts[(g_frame_count - frame_count) % PROFILER_MAX_FRAMES];
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+
+    for (int t = 0; t < thread_total(); t++) {
+        const ProfilerThread* thread = atomic_load_explicit(&g_threads[t], memory_order_acquire);
+        if (!thread) continue;
+
+        // Threads are numbered in the order they recorded their first zone
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+                      "\"args\":{\"name\":\"thread %d\"}}",
+                first ? "" : ",\n", t, t);
+        first = false;
+
+        const unsigned long long written = atomic_load_explicit(&thread->written, memory_order_acquire);
+        const unsigned long long oldest = written > PROFILER_RING_SIZE ? written - PROFILER_RING_SIZE : 0;
+        for (unsigned long long i = oldest; i < written; i++) {
+            const ZoneRecord* record = &thread->records[i & (PROFILER_RING_SIZE - 1)];
+            if (record->start_ns < since) continue;
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    record->name, t,
+                    (double)(record->start_ns - since) / 1e3,
+                    (double)(record->end_ns - record->start_ns) / 1e3);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
+
+#endif // PROFILER_ENABLED
@@ -0,0 +1,88 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+
+// Frame profiler with scoped timing zones.
+//
+// Zones are recorded per thread into a lock-free ring buffer: only the owning
+// thread writes its ring, and the frame owner reads all rings at
+// profiler_frame_end to build a per-zone breakdown of the frame. The last frames
+// can be written out as a Chrome trace (chrome://tracing, ui.perfetto.dev).
+//
+// Built with PROFILER_ENABLED (CMake option USE_PROFILER). Without it every
+// macro expands to nothing and the functions are empty inline stubs.
+//
+// Zone names must be string literals (or otherwise outlive the profiler): only
+// the pointer is stored, and zones are aggregated by pointer.
+
+#define PROFILER_RING_SIZE 65536  // Zone records per thread, power of two
+#define PROFILER_MAX_THREADS 64
+#define PROFILER_MAX_DEPTH 32     // Open zones per thread
+#define PROFILER_MAX_ZONES 64     // Distinct zone names per frame breakdown
+#define PROFILER_MAX_FRAMES 256   // Frame boundaries kept for trace export
+
+typedef struct {
+    const char* name;
+    double ms;   // Inclusive time in this zone during the frame, all threads
+    int calls;
+} ProfilerZoneStats;
+
+typedef struct {
+    double frame_ms;
+    int zone_count;
+    ProfilerZoneStats zones[PROFILER_MAX_ZONES]; // In first-seen order
+} ProfilerFrame;
+
+#ifdef PROFILER_ENABLED
+
+void profiler_begin_zone(const char* name);
+void profiler_end_zone(void);
+
+// Close the current frame: aggregate the zones recorded since the last call and
+// keep the result if it is the worst frame so far. Call once per frame, from one thread.
+void profiler_frame_end(void);
+
+const ProfilerFrame* profiler_last_frame(void);
+const ProfilerFrame* profiler_worst_frame(void);
+void profiler_reset_worst(void);
+
+// Write the zones of the last frame_count frames as Chrome trace JSON.
+// Call between frames, while no other thread is recording.
+bool profiler_write_trace(const char* path, int frame_count);
+
+static inline void profiler_zone_cleanup(const char** name) {
+    (void)name;
+    profiler_end_zone();
+}
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+// Time the rest of the enclosing scope
+#define PROFILE_ZONE(name) \
+    const char* PROFILER_CONCAT(profiler_zone_, __LINE__) __attribute__((cleanup(profiler_zone_cleanup))) = \
+        (profiler_begin_zone(name), name)
+
+#define PROFILE_BEGIN(name) profiler_begin_zone(name)
+#define PROFILE_END() profiler_end_zone()
+
+#else
+
+static inline void profiler_frame_end(void) {}
+static inline const ProfilerFrame* profiler_last_frame(void) { return 0; }
+static inline const ProfilerFrame* profiler_worst_frame(void) { return 0; }
+static inline void profiler_reset_worst(void) {}
+static inline bool profiler_write_trace(const char* path, int frame_count) {
+    (void)path;
+    (void)frame_count;
+    return false;
+}
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+
+#endif // PROFILER_ENABLED
+
+#endif // PROFILER_H
@@ -0,0 +1,54 @@
+#include "render.h"
+#include "game.h"
+#include "profiler.h"
+
+void RecordBodies(ecs_world_t *world, RenderCommandBuffer *buffer, int screenWidth, int screenHeight) {
+    PROFILE_ZONE("RecordBodies");
+    const GameState *state = ecs_singleton_get(world, GameState);
+
+    // Camera for the whole frame (same transform as WorldToScreen)
+    const Vector2 screenCenter = {screenWidth / 2.0f, screenHeight / 2.0f};
+    const Vector2 camera = state->camera;
+    const float zoom = state->zoom;
+    const AABB view = {
+        camera.x - screenCenter.x / zoom, camera.y - screenCenter.y / zoom,
+        camera.x + screenCenter.x / zoom, camera.y + screenCenter.y / zoom
+    };
+
+    const ecs_entity_t *candidates;
+    const BodyCluster *clusters;
+    int clusterCount;
+    const int candidateCount = GameQueryVisible(view, RENDER_CLUSTER_PIXELS / zoom, &candidates,
+                                                &clusters, &clusterCount);
+
+    for (int i = 0; i < candidateCount; i++) {
+        // The index is from the physics step; bodies frozen since then are gone
+        if (!ecs_is_alive(world, candidates[i])) continue;
+        const Renderable *r = ecs_get(world, candidates[i], Renderable);
+        if (!r || !aabb_intersects(aabb_from_circle(r->position, r->radius), view)) continue;
+
+        const Vector2 screenPosition = {
+            screenCenter.x + (r->position.x - camera.x) * zoom,
+            screenCenter.y + (r->position.y - camera.y) * zoom
+        };
+
+        const float screenRadius = r->radius * zoom;
+        render_circle(buffer, RENDER_LAYER_BODIES, screenRadius < RENDER_POINT_PIXELS ? RENDER_POINT : RENDER_FILL,
+                      r->colorIndex, screenPosition, screenRadius, 255);
+    }
+
+    for (int i = 0; i < clusterCount; i++) {
+        const BodyCluster *cluster = &clusters[i];
+        const Renderable *member = ecs_is_alive(world, cluster->entity)
+                                       ? ecs_get(world, cluster->entity, Renderable)
+                                       : NULL;
+
+        const Vector2 screenPosition = {
+            screenCenter.x + (cluster->center.x - camera.x) * zoom,
+            screenCenter.y + (cluster->center.y - camera.y) * zoom
+        };
+        const float screenRadius = cluster->radius * zoom;
+        render_circle(buffer, RENDER_LAYER_BODIES, screenRadius < RENDER_POINT_PIXELS ? RENDER_POINT : RENDER_FILL,
+                      member ? member->colorIndex : COLOR_FOREGROUND, screenPosition, screenRadius, 255);
+    }
+}
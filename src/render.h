@@ -0,0 +1,20 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <flecs.h>
+#include "render_commands.h"
+
+// Records the world's visible bodies as draw commands. Shared by the game's
+// RenderSystem and sim_bench --render, so both measure the same path.
+
+// Render LOD: bodies smaller than this on screen (radius, pixels) are drawn as
+// points, and quadtree nodes smaller than RENDER_CLUSTER_PIXELS as one blob with
+// the combined area of their bodies, so dense zoomed-out swarms cost a few draws
+#define RENDER_POINT_PIXELS 1.5f
+#define RENDER_CLUSTER_PIXELS 4.0f
+
+// Bodies the quadtree places in the zoom-adjusted view of a screenWidth x
+// screenHeight screen, in screen space
+void RecordBodies(ecs_world_t *world, RenderCommandBuffer *buffer, int screenWidth, int screenHeight);
+
+#endif // RENDER_H
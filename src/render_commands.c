@@ -0,0 +1,137 @@
+#include "render_commands.h"
+#include <math.h>
+#include <string.h>
+#include <rlgl.h>
+#include "memtrack.h"
+#include "profiler.h"
+
+// Unit circle, tessellated once and scaled per command
+static Vector2 g_unit_circle[RENDER_CIRCLE_SEGMENTS + 1];
+static bool g_unit_circle_ready = false;
+
+static void tessellate_unit_circle(void) {
+    for (int i = 0; i <= RENDER_CIRCLE_SEGMENTS; i++) {
+        const float angle = 2.0f * PI * (float)i / RENDER_CIRCLE_SEGMENTS;
+        g_unit_circle[i] = (Vector2){cosf(angle), sinf(angle)};
+    }
+    g_unit_circle_ready = true;
+}
+
+// === Recording ===
+
+void render_commands_begin(RenderCommandBuffer* buffer, const Color palette[RENDER_PALETTE_SIZE]) {
+    buffer->count = 0;
+    memcpy(buffer->palette, palette, sizeof(buffer->palette));
+}
+
+void render_circle(RenderCommandBuffer* buffer, RenderLayer layer, RenderShape shape,
+                   int palette_index, Vector2 position, float radius, unsigned char alpha) {
+    if (buffer->count == buffer->capacity) {
+        // Grow into temporaries: on failure the buffer keeps its old arrays and
+        // the command is dropped. A grown commands array alone is harmless, the
+        // capacity only moves once both are large enough.
+        const int capacity = buffer->capacity ? buffer->capacity * 2 : 1024;
+        RenderCommand* commands = memtrack_realloc(MEMTRACK_RENDER, buffer->commands,
+                                                   sizeof(RenderCommand) * capacity);
+        if (!commands) return;
+        buffer->commands = commands;
+
+        RenderCommand* sorted = memtrack_realloc(MEMTRACK_RENDER, buffer->sorted, sizeof(RenderCommand) * capacity);
+        if (!sorted) return;
+        buffer->sorted = sorted;
+        buffer->capacity = capacity;
+    }
+
+    buffer->commands[buffer->count++] = (RenderCommand){
+        .position = position,
+        .radius = radius,
+        .key = render_key(layer, shape, palette_index),
+        .alpha = alpha
+    };
+}
+
+// === Submission ===
+
+void render_commands_sort(RenderCommandBuffer* buffer) {
+    int* start = buffer->bucket_start;
+    memset(start, 0, sizeof(buffer->bucket_start));
+
+    for (int i = 0; i < buffer->count; i++) {
+        start[buffer->commands[i].key + 1]++;
+    }
+    for (int k = 0; k < RENDER_KEY_COUNT; k++) {
+        start[k + 1] += start[k];
+    }
+
+    // Scatter with a running cursor per key; start[] ends up as bucket starts again
+    int cursor[RENDER_KEY_COUNT];
+    memcpy(cursor, start, sizeof(cursor));
+    for (int i = 0; i < buffer->count; i++) {
+        buffer->sorted[cursor[buffer->commands[i].key]++] = buffer->commands[i];
+    }
+}
+
+void render_commands_submit(RenderCommandBuffer* buffer) {
+    PROFILE_ZONE("RenderSubmit");
+    if (!g_unit_circle_ready) tessellate_unit_circle();
+    render_commands_sort(buffer);
+
+    for (int key = 0; key < RENDER_KEY_COUNT; key++) {
+        const int begin = buffer->bucket_start[key];
+        const int end = buffer->bucket_start[key + 1];
+        if (begin == end) continue;
+
+        const RenderShape shape = render_key_shape((unsigned char)key);
+        const bool outline = shape == RENDER_OUTLINE;
+        const int vertices = shape == RENDER_POINT ? 6 : RENDER_CIRCLE_SEGMENTS * (outline ? 2 : 3);
+        Color color = buffer->palette[key & (RENDER_PALETTE_SIZE - 1)];
+
+        for (int c = begin; c < end; c++) {
+            const RenderCommand* command = &buffer->sorted[c];
+            const Vector2 center = command->position;
+            const float r = command->radius;
+            color.a = command->alpha;
+
+            // Flushes the batch if this circle wouldn't fit; consecutive
+            // begin/end pairs of the same mode share one draw call
+            rlCheckRenderBatchLimit(vertices);
+            if (shape == RENDER_POINT) {
+                // Two triangles, so points share the draw call of the fills
+                const float h = r > 0.5f ? r : 0.5f;
+                rlBegin(RL_TRIANGLES);
+                rlColor4ub(color.r, color.g, color.b, color.a);
+                rlVertex2f(center.x - h, center.y - h);
+                rlVertex2f(center.x - h, center.y + h);
+                rlVertex2f(center.x + h, center.y + h);
+                rlVertex2f(center.x - h, center.y - h);
+                rlVertex2f(center.x + h, center.y + h);
+                rlVertex2f(center.x + h, center.y - h);
+                rlEnd();
+                continue;
+            }
+
+            rlBegin(outline ? RL_LINES : RL_TRIANGLES);
+            rlColor4ub(color.r, color.g, color.b, color.a);
+            for (int s = 0; s < RENDER_CIRCLE_SEGMENTS; s++) {
+                const Vector2 a = g_unit_circle[s];
+                const Vector2 b = g_unit_circle[s + 1];
+                if (outline) {
+                    rlVertex2f(center.x + a.x * r, center.y + a.y * r);
+                    rlVertex2f(center.x + b.x * r, center.y + b.y * r);
+                } else {
+                    // Same winding as raylib's DrawCircleSector
+                    rlVertex2f(center.x, center.y);
+                    rlVertex2f(center.x + b.x * r, center.y + b.y * r);
+                    rlVertex2f(center.x + a.x * r, center.y + a.y * r);
+                }
+            }
+            rlEnd();
+        }
+    }
+}
+
+void render_commands_free(RenderCommandBuffer* buffer) {
+    memtrack_free(buffer->commands);
+    memtrack_free(buffer->sorted);
+    *buffer = (RenderCommandBuffer){0};
+}
@@ -0,0 +1,72 @@
+#ifndef RENDER_COMMANDS_H
+#define RENDER_COMMANDS_H
+
+#include <raylib.h>
+
+// CPU-side draw command buffer.
+// Render systems record compact commands instead of drawing immediately. At the
+// end of the frame the buffer is bucketed by sort key (layer, shape, palette
+// index) and submitted in one pass of pre-tessellated circles through rlgl.
+// Colors come from a palette resolved once per frame. Recording and sorting
+// don't touch the GPU, so they can be tested headless.
+
+#define RENDER_PALETTE_SIZE 32   // Palette indices fit the low 5 bits of the key
+#define RENDER_KEY_COUNT 256
+#define RENDER_CIRCLE_SEGMENTS 36
+
+// Layers draw in order; within a layer fills, then outlines, then points
+typedef enum {
+    RENDER_LAYER_VFX,
+    RENDER_LAYER_BODIES,
+    RENDER_LAYER_COUNT
+} RenderLayer;
+
+typedef enum {
+    RENDER_FILL,
+    RENDER_OUTLINE,
+    RENDER_POINT // A small square for bodies too small to tessellate (render LOD)
+} RenderShape;
+
+typedef struct {
+    Vector2 position;    // Screen space
+    float radius;        // Pixels
+    unsigned char key;   // layer << 7 | shape << 5 | palette index
+    unsigned char alpha;
+} RenderCommand;
+
+typedef struct {
+    RenderCommand* commands; // Recording order
+    RenderCommand* sorted;   // Submission order, filled by render_commands_sort
+    int count;
+    int capacity;
+    Color palette[RENDER_PALETTE_SIZE];
+    int bucket_start[RENDER_KEY_COUNT + 1]; // Sorted range of each key
+} RenderCommandBuffer;
+
+static inline RenderShape render_key_shape(unsigned char key) {
+    return (RenderShape)((key >> 5) & 3);
+}
+
+static inline unsigned char render_key(RenderLayer layer, RenderShape shape, int palette_index) {
+    return (unsigned char)((layer << 7) | (shape << 5) | (palette_index & (RENDER_PALETTE_SIZE - 1)));
+}
+
+// === Recording ===
+
+// Start a frame: drop last frame's commands and take this frame's palette
+void render_commands_begin(RenderCommandBuffer* buffer, const Color palette[RENDER_PALETTE_SIZE]);
+
+void render_circle(RenderCommandBuffer* buffer, RenderLayer layer, RenderShape shape,
+                   int palette_index, Vector2 position, float radius, unsigned char alpha);
+
+// === Submission ===
+
+// Stable counting sort by key into buffer->sorted
+void render_commands_sort(RenderCommandBuffer* buffer);
+
+// Sort and draw every command (between BeginDrawing and EndDrawing)
+void render_commands_submit(RenderCommandBuffer* buffer);
+
+void render_commands_free(RenderCommandBuffer* buffer);
+
+#endif // RENDER_COMMANDS_H
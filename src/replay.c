@@ -0,0 +1,198 @@
+#include "replay.h"
+#include <string.h>
+
+#define REPLAY_TICK_RESIZED 0x01
+
+static const char REPLAY_MAGIC[4] = {'C', 'T', 'R', 'P'};
+
+// === Little-endian helpers ===
+
+static void WriteU16(FILE *file, unsigned int value) {
+    unsigned char bytes[2] = {value & 0xFF, (value >> 8) & 0xFF};
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static void WriteU32(FILE *file, unsigned int value) {
+    unsigned char bytes[4] = {
+        value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF
+    };
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static void WriteF32(FILE *file, float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteU32(file, bits);
+}
+
+static bool ReadU8(FILE *file, unsigned int *value) {
+    int c = fgetc(file);
+    if (c == EOF) return false;
+    *value = (unsigned int) c;
+    return true;
+}
+
+static bool ReadU16(FILE *file, unsigned int *value) {
+    unsigned char bytes[2];
+    if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) return false;
+    *value = (unsigned int) bytes[0] | ((unsigned int) bytes[1] << 8);
+    return true;
+}
+
+static bool ReadU32(FILE *file, unsigned int *value) {
+    unsigned char bytes[4];
+    if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) return false;
+    *value = (unsigned int) bytes[0] | ((unsigned int) bytes[1] << 8) |
+             ((unsigned int) bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+    return true;
+}
+
+static bool ReadF32(FILE *file, float *value) {
+    unsigned int bits;
+    if (!ReadU32(file, &bits)) return false;
+    memcpy(value, &bits, sizeof(*value));
+    return true;
+}
+
+// === Recording ===
+
+bool ReplayWriterOpen(ReplayWriter *writer, const char *path, unsigned int seed, int width, int height,
+                      float worldWidth, float worldHeight) {
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        printf("Error: Cannot open replay file %s for writing\n", path);
+        return false;
+    }
+
+    writer->lastWidth = width;
+    writer->lastHeight = height;
+    writer->tickCount = 0;
+
+    fwrite(REPLAY_MAGIC, 1, sizeof(REPLAY_MAGIC), writer->file);
+    WriteU16(writer->file, REPLAY_VERSION);
+    WriteU16(writer->file, 0);
+    WriteU32(writer->file, seed);
+    WriteU16(writer->file, (unsigned int) width);
+    WriteU16(writer->file, (unsigned int) height);
+    WriteF32(writer->file, worldWidth);
+    WriteF32(writer->file, worldHeight);
+    return true;
+}
+
+void ReplayWriterTick(ReplayWriter *writer, const TickInput *input, unsigned int stateHash) {
+    if (!writer->file) return;
+
+    const bool resized = input->screenWidth != writer->lastWidth ||
+                         input->screenHeight != writer->lastHeight;
+
+    fputc((int) (input->buttons & 0xFF), writer->file);
+    fputc(resized ? REPLAY_TICK_RESIZED : 0, writer->file);
+    WriteF32(writer->file, input->dt);
+
+    if (resized) {
+        WriteU16(writer->file, (unsigned int) input->screenWidth);
+        WriteU16(writer->file, (unsigned int) input->screenHeight);
+        writer->lastWidth = input->screenWidth;
+        writer->lastHeight = input->screenHeight;
+    }
+
+    WriteU32(writer->file, stateHash);
+    writer->tickCount++;
+}
+
+void ReplayWriterClose(ReplayWriter *writer) {
+    if (!writer->file) return;
+
+    fclose(writer->file);
+    writer->file = NULL;
+}
+
+// === Playback ===
+
+bool ReplayReaderOpen(ReplayReader *reader, const char *path) {
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        printf("Error: Cannot open replay file %s\n", path);
+        return false;
+    }
+
+    char magic[4];
+    unsigned int version, reserved, seed, width, height;
+    if (fread(magic, 1, sizeof(magic), reader->file) != sizeof(magic) ||
+        memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 ||
+        !ReadU16(reader->file, &version) || !ReadU16(reader->file, &reserved) ||
+        !ReadU32(reader->file, &seed) ||
+        !ReadU16(reader->file, &width) || !ReadU16(reader->file, &height)) {
+        printf("Error: %s is not a replay file\n", path);
+        ReplayReaderClose(reader);
+        return false;
+    }
+
+    if (version < 1 || version > REPLAY_VERSION) {
+        printf("Error: Unsupported replay version %u (expected 1 to %d)\n", version, REPLAY_VERSION);
+        ReplayReaderClose(reader);
+        return false;
+    }
+
+    // Version 1 predates fixed worlds: always the screen-bound arena.
+    // Version 2 stored the world size as u16, which capped it at 65535.
+    float worldWidth = 0, worldHeight = 0;
+    bool valid = true;
+    if (version == 2) {
+        unsigned int width16, height16;
+        valid = ReadU16(reader->file, &width16) && ReadU16(reader->file, &height16);
+        worldWidth = valid ? (float) width16 : 0;
+        worldHeight = valid ? (float) height16 : 0;
+    } else if (version >= 3) {
+        valid = ReadF32(reader->file, &worldWidth) && ReadF32(reader->file, &worldHeight);
+    }
+    if (!valid) {
+        printf("Error: %s is not a replay file\n", path);
+        ReplayReaderClose(reader);
+        return false;
+    }
+
+    reader->seed = seed;
+    reader->width = (int) width;
+    reader->height = (int) height;
+    reader->worldWidth = worldWidth;
+    reader->worldHeight = worldHeight;
+    reader->tickCount = 0;
+    return true;
+}
+
+bool ReplayReaderNext(ReplayReader *reader, TickInput *input, unsigned int *stateHash) {
+    if (!reader->file) return false;
+
+    unsigned int buttons, flags;
+    float dt;
+    if (!ReadU8(reader->file, &buttons) || !ReadU8(reader->file, &flags) ||
+        !ReadF32(reader->file, &dt)) {
+        return false;
+    }
+
+    if (flags & REPLAY_TICK_RESIZED) {
+        unsigned int width, height;
+        if (!ReadU16(reader->file, &width) || !ReadU16(reader->file, &height)) return false;
+        reader->width = (int) width;
+        reader->height = (int) height;
+    }
+
+    if (!ReadU32(reader->file, stateHash)) return false;
+
+    *input = (TickInput){
+        .buttons = buttons,
+        .dt = dt,
+        .screenWidth = reader->width,
+        .screenHeight = reader->height
+    };
+    reader->tickCount++;
+    return true;
+}
+
+void ReplayReaderClose(ReplayReader *reader) {
+    if (!reader->file) return;
+
+    fclose(reader->file);
+    reader->file = NULL;
+}
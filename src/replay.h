@@ -0,0 +1,63 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "tick_input.h"
+
+// Binary input recording for reproducible runs.
+//
+// File layout (little-endian):
+//   header: "CTRP" magic, u16 version, u16 reserved, u32 seed,
+//           u16 screen width, u16 screen height,
+//           f32 world width, f32 world height (0 = screen-bound arena;
+//           version 2 stored them as u16, version 1 not at all)
+//   tick:   u8 buttons, u8 flags, f32 dt,
+//           [u16 width, u16 height if REPLAY_TICK_RESIZED],
+//           u32 state hash after the tick
+//
+// The seed is the only RNG input: the simulation RNG lives in GameState, so
+// replaying the same ticks from the same seed must reproduce every state hash.
+
+#define REPLAY_VERSION 3
+
+typedef struct {
+    FILE *file;
+    int lastWidth;
+    int lastHeight;
+    int tickCount;
+} ReplayWriter;
+
+typedef struct {
+    FILE *file;
+    unsigned int seed;
+    int width;      // Screen size of the current tick
+    int height;
+    float worldWidth; // Fixed world size to pass to GameSetWorldSize, 0 if none
+    float worldHeight;
+    int tickCount;  // Ticks read so far
+} ReplayReader;
+
+// === Recording ===
+
+// Create a recording; width/height are the screen size at the first tick,
+// worldWidth/worldHeight the fixed world size (0 for the screen-bound arena)
+bool ReplayWriterOpen(ReplayWriter *writer, const char *path, unsigned int seed, int width, int height,
+                      float worldWidth, float worldHeight);
+
+// Append one tick: the input that was applied and the state hash it produced
+void ReplayWriterTick(ReplayWriter *writer, const TickInput *input, unsigned int stateHash);
+
+void ReplayWriterClose(ReplayWriter *writer);
+
+// === Playback ===
+
+// Accepts version 1 (no world size) and 2 (u16 world size) files as well as the current version
+bool ReplayReaderOpen(ReplayReader *reader, const char *path);
+
+// Read the next tick. Returns false at end of file or on a truncated record.
+bool ReplayReaderNext(ReplayReader *reader, TickInput *input, unsigned int *stateHash);
+
+void ReplayReaderClose(ReplayReader *reader);
+
+#endif // REPLAY_H
@@ -0,0 +1,176 @@
+#include "rewind.h"
+#include <string.h>
+#include "memtrack.h"
+
+// Equal runs shorter than this are folded into the surrounding differing run:
+// two varints cost more than the bytes they would skip
+#define REWIND_MIN_EQUAL_RUN 4
+
+static bool blob_reserve(RewindBlob* blob, size_t size) {
+    if (size <= blob->capacity) return true;
+
+    size_t capacity = blob->capacity ? blob->capacity : 256;
+    while (capacity < size) capacity *= 2;
+    unsigned char* data = memtrack_realloc(MEMTRACK_SNAPSHOT, blob->data, capacity);
+    if (!data) return false;
+    blob->data = data;
+    blob->capacity = capacity;
+    return true;
+}
+
+static void blob_free(RewindBlob* blob) {
+    memtrack_free(blob->data);
+    *blob = (RewindBlob){0};
+}
+
+// === Varints ===
+
+// Callers reserve 10 bytes per varint
+static void write_varint(RewindBlob* blob, size_t value) {
+    while (value >= 0x80) {
+        blob->data[blob->size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    blob->data[blob->size++] = (unsigned char)value;
+}
+
+static bool read_varint(const unsigned char* data, size_t size, size_t* offset, size_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64 && *offset < size; shift += 7) {
+        const unsigned char byte = data[(*offset)++];
+        *value |= (size_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// === Delta coding ===
+
+bool rewind_delta_encode(const void* older, size_t older_size, const void* newer, size_t newer_size,
+                         RewindBlob* delta) {
+    const unsigned char* a = older;
+    const unsigned char* b = newer;
+    const size_t common = older_size < newer_size ? older_size : newer_size;
+
+    // Worst case: everything differs, one run
+    delta->size = 0;
+    if (!blob_reserve(delta, older_size + 30)) return false;
+    write_varint(delta, older_size);
+
+    size_t i = 0;
+    while (i < older_size) {
+        const size_t equal_start = i;
+        while (i < common && a[i] == b[i]) i++;
+        const size_t equal = i - equal_start;
+
+        // A differing run ends at an equal run long enough to be worth skipping
+        const size_t differ_start = i;
+        while (i < older_size) {
+            size_t run = 0;
+            while (i + run < common && a[i + run] == b[i + run] && run < REWIND_MIN_EQUAL_RUN) run++;
+            if (run == REWIND_MIN_EQUAL_RUN || (run > 0 && i + run == older_size)) break;
+            i += run ? run : 1;
+        }
+        const size_t differ = i - differ_start;
+
+        if (!blob_reserve(delta, delta->size + 20 + differ)) return false;
+        write_varint(delta, equal);
+        write_varint(delta, differ);
+        memcpy(delta->data + delta->size, a + differ_start, differ);
+        delta->size += differ;
+    }
+    return true;
+}
+
+bool rewind_delta_apply(const void* delta, size_t delta_size, const void* newer, size_t newer_size,
+                        RewindBlob* older) {
+    const unsigned char* d = delta;
+    const unsigned char* b = newer;
+    size_t offset = 0;
+
+    size_t older_size;
+    if (!read_varint(d, delta_size, &offset, &older_size)) return false;
+    if (!blob_reserve(older, older_size)) return false;
+
+    size_t i = 0;
+    while (i < older_size) {
+        size_t equal, differ;
+        if (!read_varint(d, delta_size, &offset, &equal) || !read_varint(d, delta_size, &offset, &differ)) {
+            return false;
+        }
+        if (equal > older_size - i || i + equal > newer_size) return false;
+        memcpy(older->data + i, b + i, equal);
+        i += equal;
+
+        if (differ > older_size - i || differ > delta_size - offset) return false;
+        memcpy(older->data + i, d + offset, differ);
+        offset += differ;
+        i += differ;
+    }
+    older->size = older_size;
+    return offset == delta_size;
+}
+
+// === Buffer ===
+
+bool rewind_init(RewindBuffer* buffer, int max_steps) {
+    *buffer = (RewindBuffer){0};
+    if (max_steps <= 0) return true;
+
+    buffer->deltas = memtrack_calloc(MEMTRACK_SNAPSHOT, max_steps, sizeof(RewindBlob));
+    if (!buffer->deltas) return false;
+    buffer->max_steps = max_steps;
+    return true;
+}
+
+bool rewind_push(RewindBuffer* buffer, const void* state, size_t size) {
+    if (buffer->head.size > 0 && buffer->max_steps > 0) {
+        // Full: the oldest delta goes, its storage is reused for the new one
+        if (buffer->count == buffer->max_steps) {
+            buffer->start = (buffer->start + 1) % buffer->max_steps;
+            buffer->count--;
+        }
+
+        RewindBlob* delta = &buffer->deltas[(buffer->start + buffer->count) % buffer->max_steps];
+        if (!rewind_delta_encode(buffer->head.data, buffer->head.size, state, size, delta)) return false;
+        buffer->count++;
+    }
+
+    if (!blob_reserve(&buffer->head, size)) return false;
+    memcpy(buffer->head.data, state, size);
+    buffer->head.size = size;
+    return true;
+}
+
+bool rewind_step_back(RewindBuffer* buffer) {
+    if (buffer->count == 0) return false;
+
+    const RewindBlob* delta = &buffer->deltas[(buffer->start + buffer->count - 1) % buffer->max_steps];
+    if (!rewind_delta_apply(delta->data, delta->size, buffer->head.data, buffer->head.size, &buffer->scratch)) {
+        return false;
+    }
+    buffer->count--;
+
+    const RewindBlob previous = buffer->head;
+    buffer->head = buffer->scratch;
+    buffer->scratch = previous;
+    return true;
+}
+
+size_t rewind_bytes(const RewindBuffer* buffer) {
+    size_t bytes = buffer->head.size;
+    for (int k = 0; k < buffer->count; k++) {
+        bytes += buffer->deltas[(buffer->start + k) % buffer->max_steps].size;
+    }
+    return bytes;
+}
+
+void rewind_free(RewindBuffer* buffer) {
+    for (int k = 0; k < buffer->max_steps; k++) {
+        blob_free(&buffer->deltas[k]);
+    }
+    memtrack_free(buffer->deltas);
+    blob_free(&buffer->head);
+    blob_free(&buffer->scratch);
+    *buffer = (RewindBuffer){0};
+}
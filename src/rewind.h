@@ -0,0 +1,60 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Rewind buffer: the last states of a byte blob (serialized world snapshots).
+//
+// Only the newest state is kept in full. Every older state is stored as a delta
+// against the state after it, so consecutive states that differ in a few bytes
+// cost a few bytes. Stepping back applies one delta, and when the buffer is full
+// the oldest delta is simply dropped.
+//
+// Delta format: the older state's size, then runs of (bytes equal to the newer
+// state, bytes that differ) until the older state is complete, each differing
+// run followed by its bytes. Sizes and run lengths are LEB128 varints. Bytes past
+// the end of the newer state always differ.
+
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} RewindBlob;
+
+typedef struct {
+    RewindBlob head;     // Newest state
+    RewindBlob* deltas;  // Ring of max_steps deltas, oldest at start
+    int max_steps;
+    int start;
+    int count;           // States before head that can be stepped back to
+    RewindBlob scratch;
+} RewindBuffer;
+
+// === Buffer ===
+
+// Keep up to max_steps states besides the newest. Returns false if out of memory.
+bool rewind_init(RewindBuffer* buffer, int max_steps);
+
+// Make state the newest, keeping the previous newest as a delta against it
+bool rewind_push(RewindBuffer* buffer, const void* state, size_t size);
+
+// Replace the newest state with the one before it. Returns false if there is none.
+bool rewind_step_back(RewindBuffer* buffer);
+
+// Bytes held: the newest state plus all deltas
+size_t rewind_bytes(const RewindBuffer* buffer);
+
+void rewind_free(RewindBuffer* buffer);
+
+// === Delta coding ===
+
+// Encode older as a delta against newer into delta (storage reused)
+bool rewind_delta_encode(const void* older, size_t older_size, const void* newer, size_t newer_size,
+                         RewindBlob* delta);
+
+// Rebuild older from newer and a delta. Returns false if the delta is malformed.
+bool rewind_delta_apply(const void* delta, size_t delta_size, const void* newer, size_t newer_size,
+                        RewindBlob* older);
+
+#endif // REWIND_H
@@ -0,0 +1,125 @@
+#include "sectors.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "game.h"
+#include "memtrack.h"
+
+SectorGrid g_sectors = {0};
+
+// Enemies that may be frozen; created with the grid, released with it
+static ecs_query_t *g_freezeQuery = NULL;
+
+void SectorsInit(ecs_world_t *world, float worldWidth, float worldHeight) {
+    SectorsShutdown();
+
+    g_sectors.columns = MAX(1, (int) ceilf(worldWidth / SECTOR_SIZE));
+    g_sectors.rows = MAX(1, (int) ceilf(worldHeight / SECTOR_SIZE));
+    g_sectors.sectors = memtrack_calloc(MEMTRACK_SECTORS, g_sectors.columns * g_sectors.rows, sizeof(Sector));
+
+    // Created up front: a query created mid-run would take entity ids from the run
+    g_freezeQuery = ecs_query(world, {
+       .terms = {
+       { ecs_id(EnemyInput) }, { ecs_id(Renderable) }, { ecs_id(Velocity) },
+       { ecs_id(Health), .oper = EcsOptional },
+       { ecs_id(RadiusTween), .oper = EcsOptional },
+       },
+       .cache_kind = EcsQueryCacheAuto
+    });
+}
+
+void SectorsShutdown(void) {
+    if (g_sectors.sectors) {
+        for (int i = 0; i < g_sectors.columns * g_sectors.rows; i++) {
+            memtrack_free(g_sectors.sectors[i].bodies);
+        }
+        memtrack_free(g_sectors.sectors);
+    }
+    memset(&g_sectors, 0, sizeof(g_sectors));
+
+    if (g_freezeQuery) {
+        ecs_query_fini(g_freezeQuery);
+        g_freezeQuery = NULL;
+    }
+}
+
+int SectorIndexAt(Vector2 position) {
+    const int column = CLAMP((int) floorf(position.x / SECTOR_SIZE), 0, g_sectors.columns - 1);
+    const int row = CLAMP((int) floorf(position.y / SECTOR_SIZE), 0, g_sectors.rows - 1);
+    return row * g_sectors.columns + column;
+}
+
+static void FreezeBody(Sector *sector, FrozenBody body) {
+    if (sector->count == sector->capacity) {
+        sector->capacity = sector->capacity ? sector->capacity * 2 : 64;
+        sector->bodies = memtrack_realloc(MEMTRACK_SECTORS, sector->bodies, sizeof(FrozenBody) * sector->capacity);
+    }
+    sector->bodies[sector->count++] = body;
+}
+
+static void ThawSector(ecs_world_t *world, Sector *sector) {
+    for (int i = 0; i < sector->count; i++) {
+        const FrozenBody *body = &sector->bodies[i];
+        RestoreEnemy(world, body->position, body->velocity, body->radius, body->health);
+    }
+
+    // Release the memory: a sector that stays active doesn't need it
+    memtrack_free(sector->bodies);
+    sector->bodies = NULL;
+    sector->count = 0;
+    sector->capacity = 0;
+}
+
+void SectorsUpdate(ecs_world_t *world, Vector2 focus) {
+    if (!g_sectors.sectors || !g_freezeQuery) return;
+
+    // Wake and sleep sectors around the focus
+    const int focusIndex = SectorIndexAt(focus);
+    const int focusColumn = focusIndex % g_sectors.columns;
+    const int focusRow = focusIndex / g_sectors.columns;
+
+    g_sectors.activeSectors = 0;
+    g_sectors.frozenBodies = 0;
+    for (int row = 0; row < g_sectors.rows; row++) {
+        for (int column = 0; column < g_sectors.columns; column++) {
+            Sector *sector = &g_sectors.sectors[row * g_sectors.columns + column];
+            const int distance = MAX(abs(column - focusColumn), abs(row - focusRow));
+
+            if (!sector->active && distance <= SECTOR_WAKE_RADIUS) {
+                sector->active = true;
+                ThawSector(world, sector);
+            } else if (sector->active && distance > SECTOR_SLEEP_RADIUS) {
+                sector->active = false;
+            }
+
+            if (sector->active) g_sectors.activeSectors++;
+        }
+    }
+
+    // Freeze enemies that are in (or drifted into) dormant sectors. Bodies still
+    // animating (spawning or being destroyed) wait until their animation ends.
+    ecs_iter_t it = ecs_query_iter(world, g_freezeQuery);
+    while (ecs_query_next(&it)) {
+        const Renderable *r = ecs_field(&it, Renderable, 1);
+        const Velocity *v = ecs_field(&it, Velocity, 2);
+        const Health *h = ecs_field_is_set(&it, 3) ? ecs_field(&it, Health, 3) : NULL;
+        const RadiusTween *tween = ecs_field_is_set(&it, 4) ? ecs_field(&it, RadiusTween, 4) : NULL;
+
+        for (int i = 0; i < it.count; i++) {
+            Sector *sector = &g_sectors.sectors[SectorIndexAt(r[i].position)];
+            if (sector->active || (tween && tween_running(&g_tweens, tween[i].handle, it.entities[i]))) continue;
+
+            FreezeBody(sector, (FrozenBody){
+                           .position = r[i].position,
+                           .velocity = v[i].velocity,
+                           .radius = r[i].radius,
+                           .health = h ? h[i].health : 100
+                       });
+            ecs_delete(world, it.entities[i]);
+        }
+    }
+
+    for (int i = 0; i < g_sectors.columns * g_sectors.rows; i++) {
+        g_sectors.frozenBodies += g_sectors.sectors[i].count;
+    }
+}
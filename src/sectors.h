@@ -0,0 +1,62 @@
+#ifndef SECTORS_H
+#define SECTORS_H
+
+#include <stdbool.h>
+#include <flecs.h>
+#include <raylib.h>
+
+// Sector streaming for bounded worlds (GameState.worldWidth/worldHeight > 0).
+//
+// The world is split into square sectors. Sectors near the camera are active:
+// their enemies are ordinary flecs entities simulated every tick. Everything else
+// is dormant: its enemies are removed from flecs and kept as a dense array of
+// FrozenBody per sector, costing neither ECS storage nor simulation time. A
+// dormant sector is thawed back into entities when the camera comes close again.
+
+#define SECTOR_SIZE 512.0f
+
+// Sectors within this many sectors of the camera's sector (Chebyshev distance) wake up...
+#define SECTOR_WAKE_RADIUS 2
+// ...and only go dormant again beyond this one, so the border doesn't thrash
+#define SECTOR_SLEEP_RADIUS 3
+
+// A dormant enemy: just what is needed to recreate it
+typedef struct {
+    Vector2 position;
+    Vector2 velocity;
+    float radius;
+    float health;
+} FrozenBody;
+
+typedef struct {
+    FrozenBody *bodies;
+    int count;
+    int capacity;
+    bool active;
+} Sector;
+
+typedef struct {
+    Sector *sectors; // columns * rows, row-major
+    int columns;
+    int rows;
+    int activeSectors;
+    int frozenBodies;
+} SectorGrid;
+
+extern SectorGrid g_sectors;
+
+// Split a width x height world into sectors; all start dormant and empty.
+// Also creates the freeze query, so call it before the run takes entity ids.
+void SectorsInit(ecs_world_t *world, float worldWidth, float worldHeight);
+
+// Also releases the cached query, so call it before the world is destroyed
+void SectorsShutdown(void);
+
+// Wake sectors near focus, put far ones to sleep, and freeze enemies standing
+// in dormant sectors. Must run inside a system (entity changes are deferred).
+void SectorsUpdate(ecs_world_t *world, Vector2 focus);
+
+// Sector containing a world position (clamped to the grid)
+int SectorIndexAt(Vector2 position);
+
+#endif // SECTORS_H
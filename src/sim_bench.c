@@ -0,0 +1,539 @@
+// Headless simulation throughput benchmark.
+// Spawns enemies in a chosen distribution, runs fixed ticks without a window,
+// audio device or keyboard, and reports ns per tick for each simulation system.
+// With --render it also rasterizes the visible bodies each tick in software.
+// With --replay it instead re-runs a recording made by c_test --record as fast
+// as possible, checking the state hash of every tick.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <flecs.h>
+#include <raylib.h>
+#include "game.h"
+#include "replay.h"
+#include "jobs.h"
+#include "memtrack.h"
+#include "frame_arena.h"
+#include "render.h"
+#include "soft_raster.h"
+#include "snapshot.h"
+#include "rewind.h"
+
+typedef enum {
+    DIST_UNIFORM,
+    DIST_CLUSTERED,
+    DIST_ATTRACT,
+    DIST_NBODY,
+    DIST_FLOCK,
+    DIST_COUNT
+} Distribution;
+
+static const char *DISTRIBUTION_NAMES[DIST_COUNT] = {"uniform", "clustered", "attract", "nbody", "flock"};
+
+typedef struct {
+    int enemies;
+    int ticks;
+    int warmup;
+    float dt;
+    int width;
+    int height;
+    unsigned int seed;
+    int distribution; // -1 = all
+    float theta;      // Barnes-Hut opening angle for the nbody distribution
+    float skin;       // Verlet skin for neighbor lists (0 = rebuild every tick)
+    float lodDistances[SIM_LOD_COUNT - 1]; // LOD band edges (0 = unbounded)
+    bool lodSet;      // --lod given: overrides the world's own LOD bands
+    float worldWidth; // Fixed sector-streamed world (0 = screen-bound arena)
+    float worldHeight;
+    int threads;      // Job worker threads besides the main thread (-1 = one per core)
+    bool render;      // Record and software-rasterize visible bodies every tick
+    bool backgroundTree; // Build each next tick's quadtree on a job worker
+    int rewind;       // Frames kept in a rewind buffer fed a snapshot every tick (0 = none)
+} BenchConfig;
+
+static double NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+// Local xorshift so spawn layouts do not depend on raylib's generator
+static unsigned int BenchRandom(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static float BenchRandomRange(unsigned int *state, float min, float max) {
+    return min + (max - min) * ((float) (BenchRandom(state) & 0xFFFFFF) / (float) 0xFFFFFF);
+}
+
+static void SpawnDistribution(ecs_world_t *world, const BenchConfig *config, Distribution dist) {
+    unsigned int rng = config->seed ? config->seed : 1;
+    const float margin = 20.0f;
+    // In a fixed world enemies are scattered over all of it, not just the screen
+    const bool fixedWorld = config->worldWidth > 0 && config->worldHeight > 0;
+    const float w = fixedWorld ? config->worldWidth : (float) config->width;
+    const float h = fixedWorld ? config->worldHeight : (float) config->height;
+
+    // Positions first, then one batch
+    Vector2 *positions = frame_scratch_alloc(sizeof(Vector2) * (config->enemies ? config->enemies : 1));
+    if (!positions) return;
+
+    if (dist == DIST_CLUSTERED) {
+        const int CLUSTER_COUNT = 16;
+        const float CLUSTER_SPREAD = 60.0f;
+        Vector2 centers[16];
+        for (int c = 0; c < CLUSTER_COUNT; c++) {
+            centers[c] = (Vector2){
+                BenchRandomRange(&rng, margin + CLUSTER_SPREAD, w - margin - CLUSTER_SPREAD),
+                BenchRandomRange(&rng, margin + CLUSTER_SPREAD, h - margin - CLUSTER_SPREAD)
+            };
+        }
+
+        for (int i = 0; i < config->enemies; i++) {
+            const Vector2 center = centers[i % CLUSTER_COUNT];
+            // Sum of uniforms approximates a gaussian around the cluster center
+            float dx = 0, dy = 0;
+            for (int k = 0; k < 3; k++) {
+                dx += BenchRandomRange(&rng, -CLUSTER_SPREAD, CLUSTER_SPREAD) / 3.0f;
+                dy += BenchRandomRange(&rng, -CLUSTER_SPREAD, CLUSTER_SPREAD) / 3.0f;
+            }
+            positions[i] = (Vector2){center.x + dx, center.y + dy};
+        }
+    } else {
+        for (int i = 0; i < config->enemies; i++) {
+            positions[i] = (Vector2){
+                BenchRandomRange(&rng, margin, w - margin),
+                BenchRandomRange(&rng, margin, h - margin)
+            };
+        }
+    }
+
+    SpawnEnemies(world, positions, config->enemies);
+}
+
+static void RunDistribution(const BenchConfig *config, Distribution dist) {
+    ecs_world_t *world = ecs_init();
+    GameInit(world, config->width, config->height, config->seed);
+    if (config->worldWidth > 0 && config->worldHeight > 0) {
+        GameSetWorldSize(world, config->worldWidth, config->worldHeight);
+    }
+    SpawnPlayer(world);
+    SpawnDistribution(world, config, dist);
+    GameState *initial = ecs_singleton_get_mut(world, GameState);
+    initial->neighborSkin = config->skin;
+    initial->backgroundQuadtree = config->backgroundTree;
+    if (config->lodSet) {
+        for (int lod = 0; lod < SIM_LOD_COUNT - 1; lod++) {
+            initial->lodDistances[lod] = config->lodDistances[lod];
+        }
+    }
+
+    TickInput input = {
+        .buttons = 0,
+        .dt = config->dt,
+        .screenWidth = config->width,
+        .screenHeight = config->height
+    };
+
+    if (dist == DIST_ATTRACT) {
+        GameState *state = ecs_singleton_get_mut(world, GameState);
+        state->physics = ATTRACT;
+        input.buttons |= INPUT_ATTRACT;
+    } else if (dist == DIST_NBODY) {
+        GameState *state = ecs_singleton_get_mut(world, GameState);
+        state->physics = NBODY;
+        state->openingAngle = config->theta;
+    } else if (dist == DIST_FLOCK) {
+        GameState *state = ecs_singleton_get_mut(world, GameState);
+        state->physics = FLOCK;
+    }
+
+    double systemNs[GAME_MAX_SYSTEMS] = {0};
+    double inputNs = 0;
+    int rebuildsBefore = 0;
+    int sortsBefore = 0;
+    int swapsBefore = 0;
+    long long allocsBefore[MEMTRACK_TAG_COUNT] = {0};
+
+    // Software draw path, timed separately from the simulation
+    RenderCommandBuffer commands = {0};
+    SoftFramebuffer framebuffer = {0};
+    Color palette[RENDER_PALETTE_SIZE];
+    for (int i = 0; i < RENDER_PALETTE_SIZE; i++) {
+        palette[i] = (Color){(unsigned char) (i * 8), (unsigned char) (255 - i * 8), 160, 255};
+    }
+    double renderNs = 0;
+    if (config->render) soft_framebuffer_init(&framebuffer, config->width, config->height);
+
+    // Rewind path: a snapshot of every tick, delta-compressed into the buffer
+    WorldSnapshot snapshot = {0};
+    RewindBuffer rewind = {0};
+    rewind_init(&rewind, config->rewind);
+    double rewindNs = 0;
+    unsigned int hashes[2] = {0}; // State hash of the previous and the last tick
+
+    for (int tick = 0; tick < config->warmup + config->ticks; tick++) {
+        const bool timed = tick >= config->warmup;
+        if (tick == config->warmup) {
+            rebuildsBefore = ecs_singleton_get(world, GameState)->neighborRebuilds;
+            sortsBefore = ecs_singleton_get(world, GameState)->spatialSorts;
+            swapsBefore = ecs_singleton_get(world, GameState)->quadtreeSwaps;
+            for (int tag = 0; tag < MEMTRACK_TAG_COUNT; tag++) {
+                allocsBefore[tag] = memtrack_stats((MemTag) tag).allocs;
+            }
+        }
+
+        double t0 = NowNs();
+        GameApplyInput(world, &input);
+        double t1 = NowNs();
+        if (timed) inputNs += t1 - t0;
+
+        for (int s = 0; s < g_game_system_count; s++) {
+            t0 = NowNs();
+            ecs_run(world, g_game_systems[s].entity, config->dt, NULL);
+            t1 = NowNs();
+            if (timed) systemNs[s] += t1 - t0;
+        }
+
+        if (framebuffer.pixels) {
+            t0 = NowNs();
+            render_commands_begin(&commands, palette);
+            RecordBodies(world, &commands, config->width, config->height);
+            soft_clear(&framebuffer, BLACK);
+            render_commands_raster(&commands, &framebuffer);
+            t1 = NowNs();
+            if (timed) renderNs += t1 - t0;
+        }
+
+        if (rewind.max_steps > 0) {
+            t0 = NowNs();
+            SnapshotCapture(world, &snapshot);
+            rewind_push(&rewind, snapshot.data, snapshot.size);
+            t1 = NowNs();
+            if (timed) rewindNs += t1 - t0;
+            hashes[0] = hashes[1];
+            hashes[1] = GameStateHash(world);
+        }
+        frame_scratch_swap();
+        memtrack_frame_end();
+    }
+
+    const int enemyCount = ecs_count(world, EnemyInput);
+    const GameState *state = ecs_singleton_get(world, GameState);
+    printf("\n=== %s: %d enemies (%d alive, %d asleep), %d ticks, dt %.4f ===\n",
+           DISTRIBUTION_NAMES[dist], config->enemies, enemyCount, state->sleepingBodies,
+           config->ticks, config->dt);
+    printf("%-28s %14s\n", "system", "ns/tick");
+
+    double totalNs = inputNs;
+    printf("%-28s %14.0f\n", "GameApplyInput", inputNs / config->ticks);
+    for (int s = 0; s < g_game_system_count; s++) {
+        printf("%-28s %14.0f\n", g_game_systems[s].name, systemNs[s] / config->ticks);
+        totalNs += systemNs[s];
+    }
+    printf("%-28s %14.0f\n", "total", totalNs / config->ticks);
+    if (framebuffer.pixels) {
+        printf("%-28s %14.0f  (%d draws last tick, not in total)\n", "software render",
+               renderNs / config->ticks, commands.count);
+    }
+    if (rewind.max_steps > 0) {
+        printf("%-28s %14.0f  (%.1f KB snapshot, not in total)\n", "snapshot + rewind push",
+               rewindNs / config->ticks, snapshot.size / 1024.0);
+        printf("%-28s %14.1f  (%d frames)\n", "rewind buffer KB", rewind_bytes(&rewind) / 1024.0, rewind.count);
+
+        // Stepping back one tick must land exactly on that tick's state
+        const double t0 = NowNs();
+        const bool stepped = rewind_step_back(&rewind);
+        const WorldSnapshot previous = {.data = rewind.head.data, .size = rewind.head.size};
+        const bool restored = stepped && SnapshotRestore(world, &previous);
+        const double t1 = NowNs();
+        printf("%-28s %14.0f  (%s)\n", "rewind step + restore ns", t1 - t0,
+               restored && GameStateHash(world) == hashes[0] ? "state hash matches" : "STATE MISMATCH");
+    }
+    printf("%-28s %14.1f\n", "ticks/s", config->ticks / (totalNs / 1e9));
+    printf("%-28s %14d  (skin %.1f)\n", "neighbor list rebuilds",
+           state->neighborRebuilds - rebuildsBefore, config->skin);
+    printf("%-28s %14d\n", "morton re-sorts", state->spatialSorts - sortsBefore);
+    if (config->backgroundTree) {
+        printf("%-28s %14d\n", "background quadtrees used", state->quadtreeSwaps - swapsBefore);
+    }
+    printf("%-28s %6d near %6d mid %6d far\n", "bodies per LOD band (last)",
+           state->lodBodies[SIM_LOD_NEAR], state->lodBodies[SIM_LOD_MID], state->lodBodies[SIM_LOD_FAR]);
+    if (state->worldWidth > 0) {
+        printf("%-28s %14d  (%d frozen enemies)\n", "active sectors (last)",
+               state->activeSectors, state->frozenBodies);
+    }
+    printf("%-28s %14.1f\n", "frame scratch peak KB", frame_scratch_current()->peak_bytes / 1024.0);
+
+    // Steady-state ticks should not allocate; peaks are since process start
+    printf("%-28s %10s %10s %12s %10s\n", "memory", "live KB", "peak KB", "allocs/tick", "last tick");
+    for (int tag = 0; tag < MEMTRACK_TAG_COUNT; tag++) {
+        const MemTagStats stats = memtrack_stats((MemTag) tag);
+        printf("  %-26s %10.1f %10.1f %12.2f %10lld\n", MEMTRACK_TAG_NAMES[tag],
+               stats.live_bytes / 1024.0, stats.peak_bytes / 1024.0,
+               (double) (stats.allocs - allocsBefore[tag]) / config->ticks, stats.last_frame_allocs);
+    }
+
+    render_commands_free(&commands);
+    soft_framebuffer_free(&framebuffer);
+    rewind_free(&rewind);
+    SnapshotFree(&snapshot);
+    GameShutdown();
+    ecs_fini(world);
+}
+
+// Two enemies resting exactly in touch far from the player, in the far LOD band.
+// They step on different ticks, so every tick at least one of them is skipped;
+// the pair must still stay one contact instead of exiting and re-entering.
+// Returns the ENTER/EXIT events for the pair after its first contact.
+static int CheckRestingFarPair(const BenchConfig *config) {
+    ecs_world_t *world = ecs_init();
+    GameInit(world, config->width, config->height, config->seed);
+    SpawnPlayer(world);
+    GameState *state = ecs_singleton_get_mut(world, GameState);
+    state->lodDistances[0] = 100.0f;
+    state->lodDistances[1] = 200.0f;
+
+    const ecs_entity_t a = RestoreEnemy(world, (Vector2){100, 100}, (Vector2){0, 0}, ENEMY_RADIUS, 100);
+    const ecs_entity_t b = RestoreEnemy(world, (Vector2){100 + 2 * ENEMY_RADIUS, 100}, (Vector2){0, 0},
+                                        ENEMY_RADIUS, 100);
+
+    const TickInput input = {
+        .buttons = 0,
+        .dt = config->dt,
+        .screenWidth = config->width,
+        .screenHeight = config->height
+    };
+    int flaps = 0;
+    bool touching = false;
+    for (int tick = 0; tick < 120; tick++) {
+        GameTick(world, &input);
+
+        int count;
+        const ContactEvent *events = GameContactEvents(&count);
+        for (int e = 0; e < count; e++) {
+            const bool pair = (events[e].a == a && events[e].b == b) || (events[e].a == b && events[e].b == a);
+            if (!pair || events[e].type == CONTACT_STAY) continue;
+            if (touching || events[e].type == CONTACT_EXIT) flaps++;
+            touching = true;
+        }
+    }
+
+    GameShutdown();
+    ecs_fini(world);
+    return touching ? flaps : -1;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    const double da = *(const double *) a;
+    const double db = *(const double *) b;
+    return (da > db) - (da < db);
+}
+
+// Re-run a recording through the same GameTick path it was recorded with
+static int RunReplay(const char *path) {
+    ReplayReader reader;
+    if (!ReplayReaderOpen(&reader, path)) return 1;
+
+    ecs_world_t *world = ecs_init();
+    GameInit(world, reader.width, reader.height, reader.seed);
+    if (reader.worldWidth > 0 && reader.worldHeight > 0) {
+        GameSetWorldSize(world, reader.worldWidth, reader.worldHeight);
+    }
+    SpawnPlayer(world);
+
+    int capacity = 1024;
+    double *tickNs = malloc(sizeof(double) * capacity);
+    int mismatches = 0;
+    int firstMismatch = -1;
+
+    TickInput input;
+    unsigned int expectedHash;
+    while (ReplayReaderNext(&reader, &input, &expectedHash)) {
+        const double t0 = NowNs();
+        GameTick(world, &input);
+        const double t1 = NowNs();
+
+        const int tick = reader.tickCount - 1;
+        if (tick >= capacity) {
+            capacity *= 2;
+            tickNs = realloc(tickNs, sizeof(double) * capacity);
+        }
+        tickNs[tick] = t1 - t0;
+
+        if (GameStateHash(world) != expectedHash) {
+            if (firstMismatch < 0) firstMismatch = tick;
+            mismatches++;
+        }
+    }
+
+    const int ticks = reader.tickCount;
+    printf("\n=== replay %s: %d ticks, seed %u, %d enemies at end ===\n",
+           path, ticks, reader.seed, ecs_count(world, EnemyInput));
+
+    if (ticks > 0) {
+        double totalNs = 0;
+        for (int i = 0; i < ticks; i++) totalNs += tickNs[i];
+
+        // Report the worst ticks before sorting so they can be located in the recording
+        printf("slowest ticks:");
+        for (int n = 0; n < 5 && n < ticks; n++) {
+            int worst = 0;
+            for (int i = 1; i < ticks; i++) {
+                if (tickNs[i] > tickNs[worst]) worst = i;
+            }
+            printf(" #%d (%.0f ns)", worst, tickNs[worst]);
+            tickNs[worst] = -tickNs[worst]; // Exclude from the next pass
+        }
+        printf("\n");
+        for (int i = 0; i < ticks; i++) {
+            if (tickNs[i] < 0) tickNs[i] = -tickNs[i];
+        }
+
+        qsort(tickNs, ticks, sizeof(double), CompareDouble);
+        printf("%-28s %14.0f\n", "mean ns/tick", totalNs / ticks);
+        printf("%-28s %14.0f\n", "p50 ns/tick", tickNs[ticks / 2]);
+        printf("%-28s %14.0f\n", "p99 ns/tick", tickNs[(int) (ticks * 0.99)]);
+        printf("%-28s %14.0f\n", "max ns/tick", tickNs[ticks - 1]);
+        printf("%-28s %14.1f\n", "ticks/s", ticks / (totalNs / 1e9));
+    }
+
+    if (mismatches > 0) {
+        printf("DESYNC: %d of %d ticks differ, first at tick %d\n", mismatches, ticks, firstMismatch);
+    } else {
+        printf("Deterministic: all %d state hashes match\n", ticks);
+    }
+
+    free(tickNs);
+    ReplayReaderClose(&reader);
+    GameShutdown();
+    ecs_fini(world);
+
+    return mismatches > 0 ? 2 : 0;
+}
+
+static void PrintUsage(const char *exe) {
+    printf("Usage: %s [options]\n", exe);
+    printf("  --enemies N        Enemies to spawn (default 2000)\n");
+    printf("  --ticks N          Timed ticks (default 600)\n");
+    printf("  --warmup N         Untimed ticks before measuring (default 120)\n");
+    printf("  --dt S             Fixed tick length in seconds (default 1/60)\n");
+    printf("  --size W H         Arena size (default 1280 720)\n");
+    printf("  --seed N           Spawn layout seed (default 1)\n");
+    printf("  --distribution D   uniform, clustered, attract, nbody, flock or all\n");
+    printf("                     (default all)\n");
+    printf("  --theta T          Barnes-Hut opening angle for nbody (default 0.5, 0 = exact)\n");
+    printf("  --skin S           Verlet skin in px for neighbor lists (default 15, 0 = every tick)\n");
+    printf("  --lod NEAR FAR     Distances from the player where half and quarter rate start\n");
+    printf("                     (default 0 0 = full rate everywhere; with --world 500 1000)\n");
+    printf("  --world W H        Fixed world streamed in sectors, enemies spread over all of it\n");
+    printf("                     (default 0 0 = the arena is the screen)\n");
+    printf("  --threads N        Job worker threads besides the main one (default -1 = per core,\n");
+    printf("                     0 = single-threaded; give it before --replay)\n");
+    printf("  --render           Also rasterize the visible bodies in software every tick\n");
+    printf("  --background-tree  Build each next tick's quadtree on a job worker\n");
+    printf("  --rewind N         Snapshot every tick into an N-frame rewind buffer, then check\n");
+    printf("                     that stepping back one tick restores its exact state\n");
+    printf("  --replay FILE      Replay a c_test --record file and verify determinism\n");
+}
+
+int main(int argc, char **argv) {
+    BenchConfig config = {
+        .enemies = 2000,
+        .ticks = 600,
+        .warmup = 120,
+        .dt = 1.0f / 60.0f,
+        .width = 1280,
+        .height = 720,
+        .seed = 1,
+        .distribution = -1,
+        .theta = 0.5f,
+        .skin = 15.0f,
+        .threads = -1
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc) {
+            config.enemies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            config.ticks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            config.warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            config.dt = (float) atof(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            config.width = atoi(argv[++i]);
+            config.height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = (unsigned int) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--theta") == 0 && i + 1 < argc) {
+            config.theta = (float) atof(argv[++i]);
+        } else if (strcmp(argv[i], "--skin") == 0 && i + 1 < argc) {
+            config.skin = (float) atof(argv[++i]);
+        } else if (strcmp(argv[i], "--lod") == 0 && i + 2 < argc) {
+            config.lodDistances[0] = (float) atof(argv[++i]);
+            config.lodDistances[1] = (float) atof(argv[++i]);
+            config.lodSet = true;
+        } else if (strcmp(argv[i], "--world") == 0 && i + 2 < argc) {
+            config.worldWidth = (float) atof(argv[++i]);
+            config.worldHeight = (float) atof(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--render") == 0) {
+            config.render = true;
+        } else if (strcmp(argv[i], "--background-tree") == 0) {
+            config.backgroundTree = true;
+        } else if (strcmp(argv[i], "--rewind") == 0 && i + 1 < argc) {
+            config.rewind = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            GameInstallMemoryTracking();
+            jobs_init(config.threads);
+            const int result = RunReplay(argv[++i]);
+            jobs_shutdown();
+            return result;
+        } else if (strcmp(argv[i], "--distribution") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            config.distribution = -2;
+            if (strcmp(name, "all") == 0) config.distribution = -1;
+            for (int d = 0; d < DIST_COUNT; d++) {
+                if (strcmp(name, DISTRIBUTION_NAMES[d]) == 0) config.distribution = d;
+            }
+            if (config.distribution == -2) {
+                printf("Unknown distribution: %s\n", name);
+                return 1;
+            }
+        } else {
+            PrintUsage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (config.ticks <= 0 || config.enemies < 0 || config.dt <= 0 || config.theta < 0 || config.skin < 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    GameInstallMemoryTracking();
+    jobs_init(config.threads);
+    printf("Job threads: %d\n", jobs_thread_count());
+
+    const int flaps = CheckRestingFarPair(&config);
+    printf("Resting far-band pair: %s\n", flaps == 0 ? "one steady contact" :
+           flaps < 0 ? "NEVER TOUCHED" : "CONTACT FLAPS (EXIT/ENTER while at rest)");
+
+    for (int d = 0; d < DIST_COUNT; d++) {
+        if (config.distribution == -1 || config.distribution == d) {
+            RunDistribution(&config, (Distribution) d);
+        }
+    }
+
+    jobs_shutdown();
+    return flaps == 0 ? 0 : 2;
+}
@@ -0,0 +1,117 @@
+#include "sim_pipeline.h"
+
+// A slot that is neither being drawn nor holding the newest frame, or -1
+static int free_slot(const SimPipeline* pipeline) {
+    for (int slot = 0; slot < SIM_PIPELINE_SLOTS; slot++) {
+        if (slot != pipeline->ready && slot != pipeline->drawing) return slot;
+    }
+    return -1;
+}
+
+static void* simulation_main(void* arg) {
+    SimPipeline* pipeline = arg;
+    if (pipeline->stage.start) pipeline->stage.start(pipeline->stage.user);
+
+    pthread_mutex_lock(&pipeline->mutex);
+    for (;;) {
+        while (!pipeline->quit && (pipeline->queue_count == 0 || free_slot(pipeline) < 0)) {
+            pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+        }
+        if (pipeline->quit) break;
+
+        const TickInput input = pipeline->queue[pipeline->queue_head];
+        pipeline->queue_head = (pipeline->queue_head + 1) % SIM_PIPELINE_QUEUE_SIZE;
+        pipeline->queue_count--;
+        const int slot = free_slot(pipeline);
+        pipeline->writing = slot;
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        pipeline->stage.step(&input, slot, pipeline->stage.user);
+
+        pthread_mutex_lock(&pipeline->mutex);
+        pipeline->writing = -1;
+        pipeline->slot_frame[slot] = pipeline->simulated++;
+        pipeline->ready = slot;  // Replaces an older frame the renderer never picked up
+        pthread_cond_broadcast(&pipeline->changed);
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    if (pipeline->stage.stop) pipeline->stage.stop(pipeline->stage.user);
+    return NULL;
+}
+
+bool sim_pipeline_start(SimPipeline* pipeline, SimPipelineStage stage) {
+    *pipeline = (SimPipeline){
+        .stage = stage,
+        .writing = -1,
+        .ready = -1,
+        .drawing = -1
+    };
+    pthread_mutex_init(&pipeline->mutex, NULL);
+    pthread_cond_init(&pipeline->changed, NULL);
+
+    if (pthread_create(&pipeline->thread, NULL, simulation_main, pipeline) != 0) {
+        pthread_cond_destroy(&pipeline->changed);
+        pthread_mutex_destroy(&pipeline->mutex);
+        return false;
+    }
+    pipeline->running = true;
+    return true;
+}
+
+void sim_pipeline_submit(SimPipeline* pipeline, const TickInput* input) {
+    pthread_mutex_lock(&pipeline->mutex);
+    while (!pipeline->quit && pipeline->queue_count == SIM_PIPELINE_QUEUE_SIZE) {
+        pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+    }
+    if (!pipeline->quit) {
+        const int tail = (pipeline->queue_head + pipeline->queue_count) % SIM_PIPELINE_QUEUE_SIZE;
+        pipeline->queue[tail] = *input;
+        pipeline->queue_count++;
+        pipeline->submitted++;
+        pthread_cond_broadcast(&pipeline->changed);
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+}
+
+int sim_pipeline_acquire(SimPipeline* pipeline) {
+    pthread_mutex_lock(&pipeline->mutex);
+    int slot = -1;
+    if (pipeline->submitted >= 2) {
+        const unsigned int wanted = pipeline->submitted - 2;
+        while (!pipeline->quit &&
+               (pipeline->ready < 0 || pipeline->slot_frame[pipeline->ready] < wanted)) {
+            pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+        }
+        if (!pipeline->quit) {
+            slot = pipeline->ready;
+            pipeline->ready = -1;
+            pipeline->drawing = slot;
+        }
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+    return slot;
+}
+
+void sim_pipeline_release(SimPipeline* pipeline, int slot) {
+    if (slot < 0) return;
+    pthread_mutex_lock(&pipeline->mutex);
+    if (pipeline->drawing == slot) pipeline->drawing = -1;
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->mutex);
+}
+
+void sim_pipeline_stop(SimPipeline* pipeline) {
+    if (!pipeline->running) return;
+
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->quit = true;
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    pthread_join(pipeline->thread, NULL);
+    pthread_cond_destroy(&pipeline->changed);
+    pthread_mutex_destroy(&pipeline->mutex);
+    pipeline->running = false;
+}
@@ -0,0 +1,71 @@
+#ifndef SIM_PIPELINE_H
+#define SIM_PIPELINE_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "game.h"
+
+// Pipelined simulation: frame N+1 is simulated on a thread of its own while the
+// main thread draws frame N, so a frame costs max(simulate, draw) instead of the
+// sum.
+//
+// The main thread submits each frame's input to a small queue. The simulation
+// thread pops inputs in order and writes each frame's results into one of
+// SIM_PIPELINE_SLOTS snapshot slots, owned by the caller; the pipeline only tracks
+// which slot is being written, which holds the newest finished frame and which
+// is being drawn. A slot is never written while it is drawn or while it holds
+// the newest frame, so everything the renderer reads from a snapshot is
+// immutable for as long as it holds it.
+//
+// Snapshots lag input by one frame: what is drawn after submitting frame N's
+// input is frame N-1 (or newer, if the simulation has caught up).
+
+#define SIM_PIPELINE_SLOTS 2
+#define SIM_PIPELINE_QUEUE_SIZE 4  // Inputs ahead of the simulation before submit blocks
+
+typedef struct {
+    // On the simulation thread, before the first frame and after the last one
+    void (*start)(void* user);
+    void (*stop)(void* user);
+    // Simulate one frame into snapshot slot
+    void (*step)(const TickInput* input, int slot, void* user);
+    void* user;
+} SimPipelineStage;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;  // Any of the fields below changed
+    SimPipelineStage stage;
+
+    TickInput queue[SIM_PIPELINE_QUEUE_SIZE];
+    int queue_head;
+    int queue_count;
+    unsigned int submitted;  // Inputs submitted so far
+    unsigned int simulated;  // Frames finished so far
+
+    unsigned int slot_frame[SIM_PIPELINE_SLOTS];  // Frame number held by each slot
+    int writing;  // Slot being simulated into, -1 if none
+    int ready;    // Slot holding the newest finished frame not yet drawn, -1 if none
+    int drawing;  // Slot held by the renderer, -1 if none
+
+    bool running;
+    bool quit;
+} SimPipeline;
+
+// Start the simulation thread. Returns false if it could not be started.
+bool sim_pipeline_start(SimPipeline* pipeline, SimPipelineStage stage);
+
+// Queue the next frame's input; blocks while SIM_PIPELINE_QUEUE_SIZE inputs are pending
+void sim_pipeline_submit(SimPipeline* pipeline, const TickInput* input);
+
+// Wait for the frame before the last submitted one (or a newer one) and hold its
+// slot until sim_pipeline_release. Returns -1 before two inputs have been submitted.
+int sim_pipeline_acquire(SimPipeline* pipeline);
+
+void sim_pipeline_release(SimPipeline* pipeline, int slot);
+
+// Drop pending inputs, finish the frame in progress and join the simulation thread
+void sim_pipeline_stop(SimPipeline* pipeline);
+
+#endif // SIM_PIPELINE_H
@@ -0,0 +1,360 @@
+#include "snapshot.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "game.h"
+#include "sectors.h"
+#include "tween.h"
+#include "memtrack.h"
+#include "profiler.h"
+
+static const char SNAPSHOT_MAGIC[4] = {'C', 'T', 'S', 'S'};
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t stateSize;
+    uint32_t tableCount;
+    uint64_t size;
+    int32_t columns;
+    int32_t rows;
+} SnapshotHeader;
+
+typedef struct {
+    int32_t count;
+    int32_t active;
+} SnapshotSector;
+
+typedef struct {
+    uint32_t mask; // Bit c set: the table has SNAPSHOT_COMPONENTS[c]
+    int32_t count;
+} SnapshotTable;
+
+// Components stored per body, in column order. Renderable is first: every body
+// has it, so it is the snapshot query's one required term.
+typedef struct {
+    const ecs_entity_t *id;
+    size_t size;
+} SnapshotComponent;
+
+#define SNAPSHOT_COMPONENT_COUNT 10
+
+static const SnapshotComponent SNAPSHOT_COMPONENTS[SNAPSHOT_COMPONENT_COUNT] = {
+    {&ecs_id(Renderable), sizeof(Renderable)},
+    {&ecs_id(Velocity), sizeof(Velocity)},
+    {&ecs_id(Health), sizeof(Health)},
+    {&ecs_id(PlayerInput), sizeof(PlayerInput)},
+    {&ecs_id(EnemyInput), sizeof(EnemyInput)},
+    {&ecs_id(RadiusTween), sizeof(RadiusTween)},
+    {&ecs_id(AttractionRangeVFX), sizeof(AttractionRangeVFX)},
+    {&ecs_id(Spike), sizeof(Spike)},
+    {&ecs_id(Mortal), sizeof(Mortal)},
+    {&ecs_id(Sleep), sizeof(Sleep)},
+};
+
+#define SNAPSHOT_PLAYER_INPUT 3
+
+// Every body table, with its optional components; created on first capture
+static ecs_query_t *g_snapshotQuery = NULL;
+
+static size_t Align8(size_t offset) {
+    return (offset + 7) & ~(size_t) 7;
+}
+
+// === Writing ===
+
+// Append size bytes at the next 8-byte boundary, or just make room for them when
+// data is NULL. Padding is zeroed so identical states give identical snapshots
+// (and small rewind deltas).
+static bool AppendBytes(WorldSnapshot *snapshot, const void *data, size_t size) {
+    const size_t offset = Align8(snapshot->size);
+    if (offset + size > snapshot->capacity) {
+        size_t capacity = snapshot->capacity ? snapshot->capacity : 4096;
+        while (capacity < offset + size) capacity *= 2;
+        unsigned char *grown = memtrack_realloc(MEMTRACK_SNAPSHOT, snapshot->data, capacity);
+        if (!grown) return false;
+        snapshot->data = grown;
+        snapshot->capacity = capacity;
+    }
+
+    memset(snapshot->data + snapshot->size, 0, offset - snapshot->size);
+    if (size > 0 && data) memcpy(snapshot->data + offset, data, size);
+    snapshot->size = offset + size;
+    return true;
+}
+
+static ecs_query_t *SnapshotQuery(ecs_world_t *world) {
+    if (!g_snapshotQuery) {
+        ecs_query_desc_t desc = {.cache_kind = EcsQueryCacheAuto};
+        for (int c = 0; c < SNAPSHOT_COMPONENT_COUNT; c++) {
+            desc.terms[c] = (ecs_term_t){
+                .id = *SNAPSHOT_COMPONENTS[c].id,
+                .oper = c == 0 ? EcsAnd : EcsOptional
+            };
+        }
+        g_snapshotQuery = ecs_query_init(world, &desc);
+    }
+    return g_snapshotQuery;
+}
+
+void SnapshotInit(ecs_world_t *world) {
+    SnapshotQuery(world);
+}
+
+bool SnapshotCapture(ecs_world_t *world, WorldSnapshot *snapshot) {
+    PROFILE_ZONE("SnapshotCapture");
+    if (snapshot->mapped) SnapshotFree(snapshot);
+    snapshot->size = 0;
+
+    SnapshotHeader header = {
+        .version = SNAPSHOT_VERSION,
+        .stateSize = sizeof(GameState),
+        .columns = g_sectors.columns,
+        .rows = g_sectors.rows
+    };
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    if (!AppendBytes(snapshot, &header, sizeof(header)) ||
+        !AppendBytes(snapshot, ecs_singleton_get(world, GameState), sizeof(GameState))) {
+        return false;
+    }
+
+    for (int s = 0; s < g_sectors.columns * g_sectors.rows; s++) {
+        const Sector *sector = &g_sectors.sectors[s];
+        const SnapshotSector record = {sector->count, sector->active};
+        if (!AppendBytes(snapshot, &record, sizeof(record)) ||
+            !AppendBytes(snapshot, sector->bodies, sizeof(FrozenBody) * sector->count)) {
+            return false;
+        }
+    }
+
+    const uint64_t tweenSize = tween_pool_save(&g_tweens, NULL);
+    if (!AppendBytes(snapshot, &tweenSize, sizeof(tweenSize)) || !AppendBytes(snapshot, NULL, tweenSize)) {
+        return false;
+    }
+    tween_pool_save(&g_tweens, snapshot->data + snapshot->size - tweenSize);
+
+    // One record per table: the entity ids, then each present component's column
+    ecs_iter_t it = ecs_query_iter(world, SnapshotQuery(world));
+    while (ecs_query_next(&it)) {
+        if (it.count == 0) continue;
+
+        SnapshotTable table = {.mask = 0, .count = it.count};
+        for (int c = 0; c < SNAPSHOT_COMPONENT_COUNT; c++) {
+            if (ecs_field_is_set(&it, c)) table.mask |= 1u << c;
+        }
+
+        bool ok = AppendBytes(snapshot, &table, sizeof(table)) &&
+                  AppendBytes(snapshot, it.entities, sizeof(ecs_entity_t) * it.count);
+        for (int c = 0; c < SNAPSHOT_COMPONENT_COUNT && ok; c++) {
+            if (!(table.mask & (1u << c))) continue;
+            const size_t size = SNAPSHOT_COMPONENTS[c].size;
+            ok = AppendBytes(snapshot, ecs_field_w_size(&it, size, c), size * it.count);
+        }
+        if (!ok) {
+            ecs_iter_fini(&it);
+            return false;
+        }
+        header.tableCount++;
+    }
+
+    header.size = snapshot->size;
+    memcpy(snapshot->data, &header, sizeof(header));
+    return true;
+}
+
+// === Reading ===
+
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    size_t offset;
+} SnapshotReader;
+
+// The next size bytes, or NULL past the end
+static const void *ReadBytes(SnapshotReader *reader, size_t size) {
+    const size_t offset = Align8(reader->offset);
+    if (offset > reader->size || size > reader->size - offset) return NULL;
+    reader->offset = offset + size;
+    return reader->data + offset;
+}
+
+// Whether ecs_bulk_init may bring these ids back: none may be in use by another
+// entity (a recycled id) when the snapshot is restored
+static bool EntityIdsFree(ecs_world_t *world, const ecs_entity_t *ids, int count) {
+    for (int i = 0; i < count; i++) {
+        if (ecs_get_alive(world, (uint32_t) ids[i]) != 0) return false;
+    }
+    return true;
+}
+
+static void RestoreSector(Sector *sector, const SnapshotSector *record, const FrozenBody *bodies) {
+    if (record->count > sector->capacity) {
+        sector->bodies = memtrack_realloc(MEMTRACK_SECTORS, sector->bodies, sizeof(FrozenBody) * record->count);
+        sector->capacity = record->count;
+    }
+    if (record->count > 0) memcpy(sector->bodies, bodies, sizeof(FrozenBody) * record->count);
+    sector->count = record->count;
+    sector->active = record->active != 0;
+}
+
+// Walk the snapshot, checking every record. With apply set, also restore each one;
+// the world is only touched after a walk without apply succeeded.
+static bool WalkSnapshot(ecs_world_t *world, const WorldSnapshot *snapshot, bool apply) {
+    SnapshotReader reader = {snapshot->data, snapshot->size, 0};
+
+    const SnapshotHeader *header = ReadBytes(&reader, sizeof(SnapshotHeader));
+    if (!header || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SNAPSHOT_VERSION || header->stateSize != sizeof(GameState) ||
+        header->size != snapshot->size ||
+        header->columns != g_sectors.columns || header->rows != g_sectors.rows) {
+        return false;
+    }
+
+    const GameState *state = ReadBytes(&reader, sizeof(GameState));
+    if (!state) return false;
+    if (apply) {
+        memcpy(ecs_singleton_get_mut(world, GameState), state, sizeof(GameState));
+    }
+
+    if (apply) {
+        g_sectors.activeSectors = 0;
+        g_sectors.frozenBodies = 0;
+    }
+    for (int s = 0; s < header->columns * header->rows; s++) {
+        const SnapshotSector *record = ReadBytes(&reader, sizeof(SnapshotSector));
+        if (!record || record->count < 0) return false;
+        const FrozenBody *bodies = ReadBytes(&reader, sizeof(FrozenBody) * (size_t) record->count);
+        if (!bodies) return false;
+
+        if (apply) {
+            RestoreSector(&g_sectors.sectors[s], record, bodies);
+            g_sectors.activeSectors += record->active != 0;
+            g_sectors.frozenBodies += record->count;
+        }
+    }
+
+    // Running springs. The checking walk loads them into a throwaway pool.
+    const uint64_t *tweenSize = ReadBytes(&reader, sizeof(uint64_t));
+    if (!tweenSize || *tweenSize > reader.size) return false;
+    const void *tweens = ReadBytes(&reader, (size_t) *tweenSize);
+    if (!tweens) return false;
+    if (apply) {
+        if (!tween_pool_load(&g_tweens, tweens, (size_t) *tweenSize)) tween_pool_clear(&g_tweens);
+    } else {
+        TweenPool check = {0};
+        const bool valid = tween_pool_load(&check, tweens, (size_t) *tweenSize);
+        tween_pool_free(&check);
+        if (!valid) return false;
+    }
+
+    // Bodies: everything with a Renderable goes, then each table comes back in one batch
+    if (apply) {
+        ecs_delete_with(world, ecs_id(Renderable));
+    }
+    for (uint32_t t = 0; t < header->tableCount; t++) {
+        const SnapshotTable *table = ReadBytes(&reader, sizeof(SnapshotTable));
+        if (!table || table->count <= 0 || !(table->mask & 1u) ||
+            table->mask >= (1u << SNAPSHOT_COMPONENT_COUNT)) {
+            return false;
+        }
+        const ecs_entity_t *ids = ReadBytes(&reader, sizeof(ecs_entity_t) * (size_t) table->count);
+        if (!ids) return false;
+
+        ecs_bulk_desc_t desc = {.count = table->count};
+        void *columns[SNAPSHOT_COMPONENT_COUNT];
+        int idCount = 0;
+        for (int c = 0; c < SNAPSHOT_COMPONENT_COUNT; c++) {
+            if (!(table->mask & (1u << c))) continue;
+            const void *column = ReadBytes(&reader, SNAPSHOT_COMPONENTS[c].size * (size_t) table->count);
+            if (!column) return false;
+
+            desc.ids[idCount] = *SNAPSHOT_COMPONENTS[c].id;
+            columns[idCount] = (void *) column;
+            idCount++;
+        }
+        if (!apply) continue;
+
+        // Keep the saved ids (LOD scheduling and contact keys use them) unless one
+        // was recycled by an entity outside the snapshot in the meantime
+        desc.entities = EntityIdsFree(world, ids, table->count) ? (ecs_entity_t *) ids : NULL;
+        desc.data = columns;
+        const ecs_entity_t *entities = ecs_bulk_init(world, &desc);
+        if (table->mask & (1u << SNAPSHOT_PLAYER_INPUT)) {
+            ecs_set_name(world, entities[0], "Player");
+        }
+    }
+
+    return reader.offset == reader.size;
+}
+
+bool SnapshotRestore(ecs_world_t *world, const WorldSnapshot *snapshot) {
+    PROFILE_ZONE("SnapshotRestore");
+    if (!WalkSnapshot(world, snapshot, false)) return false;
+
+    WalkSnapshot(world, snapshot, true);
+    GameRestored(world);
+    return true;
+}
+
+// === Files ===
+
+bool SnapshotSave(const WorldSnapshot *snapshot, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        printf("Error: Cannot open snapshot file %s for writing\n", path);
+        return false;
+    }
+
+    const bool written = fwrite(snapshot->data, 1, snapshot->size, file) == snapshot->size;
+    return fclose(file) == 0 && written;
+}
+
+bool SnapshotLoad(WorldSnapshot *snapshot, const char *path) {
+    SnapshotFree(snapshot);
+
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Error: Cannot open snapshot file %s\n", path);
+        return false;
+    }
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= (off_t) sizeof(SnapshotHeader)) {
+        // Private and writable, so the restore can hand the ids to flecs without a copy
+        data = mmap(NULL, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("Error: Cannot map snapshot file %s\n", path);
+        return false;
+    }
+
+    *snapshot = (WorldSnapshot){
+        .data = data,
+        .size = (size_t) info.st_size,
+        .capacity = (size_t) info.st_size,
+        .mapped = true
+    };
+    return true;
+}
+
+void SnapshotFree(WorldSnapshot *snapshot) {
+    if (snapshot->mapped) {
+        munmap(snapshot->data, snapshot->size);
+    } else {
+        memtrack_free(snapshot->data);
+    }
+    *snapshot = (WorldSnapshot){0};
+}
+
+void SnapshotShutdown(void) {
+    if (g_snapshotQuery) {
+        ecs_query_fini(g_snapshotQuery);
+        g_snapshotQuery = NULL;
+    }
+}
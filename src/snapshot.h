@@ -0,0 +1,59 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <flecs.h>
+
+// Whole-simulation snapshots: every body entity with its components, the
+// GameState singleton, the dormant sectors and the running tweens, in one flat
+// binary blob.
+//
+// Bodies are stored table by table and column by column, so capturing a table is
+// one memcpy per component and restoring it is one ecs_bulk_init. Every block
+// starts 8-byte aligned, so a snapshot can be used in place straight from a
+// memory-mapped file.
+//
+// Layout (native byte order and struct layout: files are for the same build):
+//   header:  "CTSS" magic, u32 version, u32 sizeof(GameState), u32 table count,
+//            u64 total size, i32 sector columns, i32 sector rows
+//   state:   GameState
+//   sector:  i32 body count, i32 active, FrozenBody[count]   (columns * rows times)
+//   tweens:  u64 size, then the tween pool (tween_pool_save)
+//   table:   u32 component mask, i32 entity count, u64 entity ids[count],
+//            then one column per component in the mask (order in snapshot.c)
+//
+// Per-tick caches (neighbor lists, contacts, body order) are not part of the state;
+// GameRestored rebuilds or resets them.
+
+#define SNAPSHOT_VERSION 2
+
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    bool mapped; // data is a read-only file mapping (SnapshotLoad)
+} WorldSnapshot;
+
+// Serialize the simulation into snapshot (storage reused). Call between ticks.
+bool SnapshotCapture(ecs_world_t *world, WorldSnapshot *snapshot);
+
+// Replace every body, GameState, the sectors and the tweens with the snapshot's.
+// Call between ticks. Returns false, leaving the world untouched, if the snapshot
+// is malformed or was taken with a different build or world size.
+bool SnapshotRestore(ecs_world_t *world, const WorldSnapshot *snapshot);
+
+bool SnapshotSave(const WorldSnapshot *snapshot, const char *path);
+
+// Map a saved snapshot; it is only checked when restored
+bool SnapshotLoad(WorldSnapshot *snapshot, const char *path);
+
+void SnapshotFree(WorldSnapshot *snapshot);
+
+// Create the snapshot query up front, before the run's entities (SpawnPlayer)
+void SnapshotInit(ecs_world_t *world);
+
+// Releases the cached query, so call it before the world is destroyed
+void SnapshotShutdown(void);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,215 @@
+#include "soft_raster.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "memtrack.h"
+#include "profiler.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static uint32_t pack_color(Color color) {
+    uint32_t packed;
+    memcpy(&packed, &color, sizeof(packed));
+    return packed;
+}
+
+// Exact round(x / 255) for x <= 255 * 255 + 128, with the +128 already added
+static inline unsigned int div255(unsigned int t) {
+    return (t + (t >> 8)) >> 8;
+}
+
+// Source-over blend of one color into count pixels:
+// c = (src * a + dst * (255 - a)) / 255 per channel, with src alpha taken as 255
+static void blend_span(uint32_t* span, int count, Color color) {
+    if (count <= 0 || color.a == 0) return;
+
+    if (color.a == 255) {
+        const uint32_t packed = pack_color(color);
+        for (int i = 0; i < count; i++) span[i] = packed;
+        return;
+    }
+
+    const unsigned int a = color.a;
+    const unsigned int ia = 255 - a;
+    const unsigned int src[4] = {color.r * a + 128, color.g * a + 128, color.b * a + 128, 255 * a + 128};
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i inverse = _mm_set1_epi16((short)ia);
+    const __m128i source = _mm_setr_epi16((short)src[0], (short)src[1], (short)src[2], (short)src[3],
+                                          (short)src[0], (short)src[1], (short)src[2], (short)src[3]);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i dst = _mm_loadu_si128((const __m128i*)(span + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), inverse), source);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), inverse), source);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(span + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < count; i++) {
+        unsigned char* pixel = (unsigned char*)(span + i);
+        for (int c = 0; c < 4; c++) {
+            pixel[c] = (unsigned char)div255(src[c] + pixel[c] * ia);
+        }
+    }
+}
+
+// Blend pixels x0..x1 (inclusive) of row y, clipped to the framebuffer
+static void blend_row(SoftFramebuffer* fb, int y, int x0, int x1, Color color) {
+    if (y < 0 || y >= fb->height) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= fb->width) x1 = fb->width - 1;
+    blend_span(fb->pixels + (size_t)y * fb->width + x0, x1 - x0 + 1, color);
+}
+
+// Columns whose pixel centers lie within half_width of cx
+static void row_span(float cx, float half_width, int* x0, int* x1) {
+    *x0 = (int)ceilf(cx - half_width - 0.5f);
+    *x1 = (int)floorf(cx + half_width - 0.5f);
+}
+
+// === Framebuffer ===
+
+bool soft_framebuffer_init(SoftFramebuffer* fb, int width, int height) {
+    fb->pixels = memtrack_calloc(MEMTRACK_RENDER, (size_t)width * height, sizeof(uint32_t));
+    fb->width = fb->pixels ? width : 0;
+    fb->height = fb->pixels ? height : 0;
+    return fb->pixels != NULL;
+}
+
+void soft_framebuffer_free(SoftFramebuffer* fb) {
+    memtrack_free(fb->pixels);
+    *fb = (SoftFramebuffer){0};
+}
+
+uint32_t soft_framebuffer_hash(const SoftFramebuffer* fb) {
+    uint32_t hash = 2166136261u;
+    const unsigned char* bytes = (const unsigned char*)fb->pixels;
+    const size_t size = (size_t)fb->width * fb->height * sizeof(uint32_t);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool soft_framebuffer_write_ppm(const SoftFramebuffer* fb, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", fb->width, fb->height);
+    for (int i = 0; i < fb->width * fb->height; i++) {
+        fwrite(&fb->pixels[i], 1, 3, file);
+    }
+    return fclose(file) == 0;
+}
+
+Color soft_pixel(const SoftFramebuffer* fb, int x, int y) {
+    Color color;
+    memcpy(&color, &fb->pixels[(size_t)y * fb->width + x], sizeof(color));
+    return color;
+}
+
+// === Primitives ===
+
+void soft_clear(SoftFramebuffer* fb, Color color) {
+    const uint32_t packed = pack_color(color);
+    const size_t count = (size_t)fb->width * fb->height;
+    for (size_t i = 0; i < count; i++) fb->pixels[i] = packed;
+}
+
+void soft_fill_circle(SoftFramebuffer* fb, Vector2 center, float radius, Color color) {
+    if (radius <= 0) return;
+
+    const int y0 = (int)ceilf(center.y - radius - 0.5f);
+    const int y1 = (int)floorf(center.y + radius - 0.5f);
+    for (int y = y0 < 0 ? 0 : y0; y <= y1 && y < fb->height; y++) {
+        const float dy = (float)y + 0.5f - center.y;
+        const float h2 = radius * radius - dy * dy;
+        if (h2 < 0) continue;
+
+        int x0, x1;
+        row_span(center.x, sqrtf(h2), &x0, &x1);
+        blend_row(fb, y, x0, x1, color);
+    }
+}
+
+void soft_circle_lines(SoftFramebuffer* fb, Vector2 center, float radius, Color color) {
+    const float outer = radius + 0.5f;
+    const float inner = radius > 0.5f ? radius - 0.5f : 0.0f;
+
+    const int y0 = (int)ceilf(center.y - outer - 0.5f);
+    const int y1 = (int)floorf(center.y + outer - 0.5f);
+    for (int y = y0 < 0 ? 0 : y0; y <= y1 && y < fb->height; y++) {
+        const float dy = (float)y + 0.5f - center.y;
+        const float outer2 = outer * outer - dy * dy;
+        if (outer2 < 0) continue;
+
+        int x0, x1;
+        row_span(center.x, sqrtf(outer2), &x0, &x1);
+
+        // Rows crossing the hole keep only the two ends of the span
+        const float inner2 = inner * inner - dy * dy;
+        if (inner2 > 0) {
+            int ix0, ix1;
+            row_span(center.x, sqrtf(inner2), &ix0, &ix1);
+            if (ix0 <= ix1) {
+                blend_row(fb, y, x0, ix0 - 1, color);
+                blend_row(fb, y, ix1 + 1, x1, color);
+                continue;
+            }
+        }
+        blend_row(fb, y, x0, x1, color);
+    }
+}
+
+void soft_fill_rectangle(SoftFramebuffer* fb, Rectangle rect, Color color) {
+    const int x0 = (int)ceilf(rect.x - 0.5f);
+    const int x1 = (int)ceilf(rect.x + rect.width - 0.5f) - 1;
+    const int y0 = (int)ceilf(rect.y - 0.5f);
+    const int y1 = (int)ceilf(rect.y + rect.height - 0.5f) - 1;
+    for (int y = y0 < 0 ? 0 : y0; y <= y1 && y < fb->height; y++) {
+        blend_row(fb, y, x0, x1, color);
+    }
+}
+
+void soft_rectangle_lines(SoftFramebuffer* fb, Rectangle rect, float thickness, Color color) {
+    // Same four bands as raylib's DrawRectangleLinesEx, so corners aren't blended twice
+    const float t = thickness;
+    soft_fill_rectangle(fb, (Rectangle){rect.x, rect.y, rect.width, t}, color);
+    soft_fill_rectangle(fb, (Rectangle){rect.x, rect.y + rect.height - t, rect.width, t}, color);
+    soft_fill_rectangle(fb, (Rectangle){rect.x, rect.y + t, t, rect.height - t * 2}, color);
+    soft_fill_rectangle(fb, (Rectangle){rect.x + rect.width - t, rect.y + t, t, rect.height - t * 2}, color);
+}
+
+// === Command buffer backend ===
+
+void render_commands_raster(RenderCommandBuffer* buffer, SoftFramebuffer* fb) {
+    PROFILE_ZONE("RenderRaster");
+    render_commands_sort(buffer);
+
+    for (int key = 0; key < RENDER_KEY_COUNT; key++) {
+        const RenderShape shape = render_key_shape((unsigned char)key);
+        Color color = buffer->palette[key & (RENDER_PALETTE_SIZE - 1)];
+
+        for (int c = buffer->bucket_start[key]; c < buffer->bucket_start[key + 1]; c++) {
+            const RenderCommand* command = &buffer->sorted[c];
+            color.a = command->alpha;
+            if (shape == RENDER_POINT) {
+                // At least one pixel, whatever the radius
+                const float h = command->radius > 0.5f ? command->radius : 0.5f;
+                soft_fill_rectangle(fb, (Rectangle){command->position.x - h, command->position.y - h, h * 2, h * 2},
+                                    color);
+            } else if (shape == RENDER_OUTLINE) {
+                soft_circle_lines(fb, command->position, command->radius, color);
+            } else {
+                soft_fill_circle(fb, command->position, command->radius, color);
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef SOFT_RASTER_H
+#define SOFT_RASTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <raylib.h>
+#include "render_commands.h"
+
+// Software rendering backend: the primitives the game draws, rasterized into an
+// in-memory RGBA framebuffer with no GPU or window. Used for golden-image tests
+// and for timing the draw path headless (sim_bench --render).
+//
+// A pixel is covered when its center is inside the shape (no anti-aliasing).
+// Spans are filled a row at a time, blending four pixels per step with SSE2 where
+// available; the scalar path gives bit-identical results.
+
+typedef struct {
+    int width;
+    int height;
+    uint32_t* pixels; // Row-major, bytes in memory order R, G, B, A (same as Color)
+} SoftFramebuffer;
+
+// === Framebuffer ===
+
+bool soft_framebuffer_init(SoftFramebuffer* fb, int width, int height);
+void soft_framebuffer_free(SoftFramebuffer* fb);
+
+// FNV-1a over the pixels, for comparing against golden images
+uint32_t soft_framebuffer_hash(const SoftFramebuffer* fb);
+
+// Binary PPM (alpha dropped), to look at a golden image that no longer matches
+bool soft_framebuffer_write_ppm(const SoftFramebuffer* fb, const char* path);
+
+Color soft_pixel(const SoftFramebuffer* fb, int x, int y);
+
+// === Primitives (source-over blending by color.a) ===
+
+void soft_clear(SoftFramebuffer* fb, Color color);
+
+// DrawCircleV / DrawCircle
+void soft_fill_circle(SoftFramebuffer* fb, Vector2 center, float radius, Color color);
+
+// DrawCircleLines: a one pixel ring
+void soft_circle_lines(SoftFramebuffer* fb, Vector2 center, float radius, Color color);
+
+void soft_fill_rectangle(SoftFramebuffer* fb, Rectangle rect, Color color);
+
+// DrawRectangleLinesEx
+void soft_rectangle_lines(SoftFramebuffer* fb, Rectangle rect, float thickness, Color color);
+
+// === Command buffer backend ===
+
+// Sort and rasterize a frame's commands; the counterpart of render_commands_submit
+void render_commands_raster(RenderCommandBuffer* buffer, SoftFramebuffer* fb);
+
+#endif // SOFT_RASTER_H
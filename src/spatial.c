@@ -4,17 +4,26 @@
 #include <math.h>
 #include <raylib.h>
 
+// Allocator used for trees and nodes (see spatial_set_allocator)
+static SpatialAllocFn g_spatial_alloc = malloc;
+static SpatialFreeFn g_spatial_free = free;
+
 // === Internal Helper Functions ===
 
 // Allocate a new quadtree node
 static QuadNode* node_create(AABB bounds, int depth) {
-    QuadNode* node = (QuadNode*)malloc(sizeof(QuadNode));
+    QuadNode* node = (QuadNode*)g_spatial_alloc(sizeof(QuadNode));
     if (!node) return NULL;
 
     node->bounds = bounds;
     node->entity_count = 0;
+    node->overflow = NULL;
+    node->overflow_count = 0;
+    node->overflow_capacity = 0;
     node->depth = depth;
     node->is_leaf = true;
+    node->mass = 0.0f;
+    node->center_of_mass = (Vector2){0, 0};
 
     for (int i = 0; i < 4; i++) {
         node->children[i] = NULL;
@@ -33,7 +42,34 @@ static void node_destroy(QuadNode* node) {
         }
     }
 
-    free(node);
+    g_spatial_free(node->overflow);
+    g_spatial_free(node);
+}
+
+// Total entities stored in a node (fixed array plus overflow)
+static inline int node_entity_total(const QuadNode* node) {
+    return node->entity_count + node->overflow_count;
+}
+
+// Entity i of a node, spanning the fixed array and the overflow
+static inline const SpatialEntity* node_entity_at(const QuadNode* node, int i) {
+    return i < node->entity_count ? &node->entities[i] : &node->overflow[i - node->entity_count];
+}
+
+// Append to a max-depth leaf's overflow array, growing it as needed
+static void node_push_overflow(QuadNode* node, SpatialEntity entity) {
+    if (node->overflow_count == node->overflow_capacity) {
+        int capacity = node->overflow_capacity ? node->overflow_capacity * 2 : QUADTREE_NODE_CAPACITY;
+        SpatialEntity* grown = (SpatialEntity*)g_spatial_alloc(sizeof(SpatialEntity) * capacity);
+        if (!grown) return;
+        if (node->overflow) {
+            memcpy(grown, node->overflow, sizeof(SpatialEntity) * node->overflow_count);
+            g_spatial_free(node->overflow);
+        }
+        node->overflow = grown;
+        node->overflow_capacity = capacity;
+    }
+    node->overflow[node->overflow_count++] = entity;
 }
 
 // Subdivide a node into 4 children (NW, NE, SW, SE)
@@ -72,12 +108,12 @@ static void node_subdivide(QuadNode* node) {
 }
 
 // Insert an entity into a specific node (recursive)
-static void node_insert(QuadNode* node, int entity_index, AABB bounds, int max_depth) {
+static void node_insert(QuadNode* node, SpatialEntity entity, int max_depth) {
     // If not a leaf, insert into appropriate child
     if (!node->is_leaf) {
         for (int i = 0; i < 4; i++) {
-            if (node->children[i] && aabb_intersects(node->children[i]->bounds, bounds)) {
-                node_insert(node->children[i], entity_index, bounds, max_depth);
+            if (node->children[i] && aabb_intersects(node->children[i]->bounds, entity.bounds)) {
+                node_insert(node->children[i], entity, max_depth);
             }
         }
         return;
@@ -85,8 +121,7 @@ static void node_insert(QuadNode* node, int entity_index, AABB bounds, int max_d
 
     // Add entity to this leaf node
     if (node->entity_count < QUADTREE_NODE_CAPACITY) {
-        node->entities[node->entity_count].index = entity_index;
-        node->entities[node->entity_count].bounds = bounds;
+        node->entities[node->entity_count] = entity;
         node->entity_count++;
         return;
     }
@@ -104,24 +139,20 @@ static void node_insert(QuadNode* node, int entity_index, AABB bounds, int max_d
         for (int i = 0; i < temp_count; i++) {
             for (int j = 0; j < 4; j++) {
                 if (aabb_intersects(node->children[j]->bounds, temp_entities[i].bounds)) {
-                    node_insert(node->children[j], temp_entities[i].index, temp_entities[i].bounds, max_depth);
+                    node_insert(node->children[j], temp_entities[i], max_depth);
                 }
             }
         }
 
         // Insert the new entity
         for (int i = 0; i < 4; i++) {
-            if (node->children[i] && aabb_intersects(node->children[i]->bounds, bounds)) {
-                node_insert(node->children[i], entity_index, bounds, max_depth);
+            if (node->children[i] && aabb_intersects(node->children[i]->bounds, entity.bounds)) {
+                node_insert(node->children[i], entity, max_depth);
             }
         }
     } else {
         // Max depth reached, force insert even if over capacity
-        if (node->entity_count < QUADTREE_NODE_CAPACITY) {
-            node->entities[node->entity_count].index = entity_index;
-            node->entities[node->entity_count].bounds = bounds;
-            node->entity_count++;
-        }
+        node_push_overflow(node, entity);
     }
 }
 
@@ -133,11 +164,13 @@ static void node_query(QuadNode* node, AABB query_bounds, int* results, int* res
 
     // If leaf, check all entities in this node
     if (node->is_leaf) {
-        for (int i = 0; i < node->entity_count; i++) {
+        const int total = node_entity_total(node);
+        for (int i = 0; i < total; i++) {
             if (*result_count >= max_results) return;
 
-            if (aabb_intersects(node->entities[i].bounds, query_bounds)) {
-                results[*result_count] = node->entities[i].index;
+            const SpatialEntity* entity = node_entity_at(node, i);
+            if (aabb_intersects(entity->bounds, query_bounds)) {
+                results[*result_count] = entity->index;
                 (*result_count)++;
             }
         }
@@ -159,9 +192,11 @@ static void node_query_callback(QuadNode* node, AABB query_bounds, QueryCallback
     }
 
     if (node->is_leaf) {
-        for (int i = 0; i < node->entity_count; i++) {
-            if (aabb_intersects(node->entities[i].bounds, query_bounds)) {
-                callback(node->entities[i].index, user_data);
+        const int total = node_entity_total(node);
+        for (int i = 0; i < total; i++) {
+            const SpatialEntity* entity = node_entity_at(node, i);
+            if (aabb_intersects(entity->bounds, query_bounds)) {
+                callback(entity->index, user_data);
             }
         }
         return;
@@ -179,6 +214,8 @@ static void node_clear(QuadNode* node) {
     if (!node) return;
 
     node->entity_count = 0;
+    node->overflow_count = 0;
+    node->mass = 0.0f;
 
     for (int i = 0; i < 4; i++) {
         if (node->children[i]) {
@@ -220,7 +257,7 @@ static int node_max_depth(QuadNode* node) {
 // === Public API Implementation ===
 
 Quadtree* quadtree_create(AABB world_bounds) {
-    Quadtree* tree = (Quadtree*)malloc(sizeof(Quadtree));
+    Quadtree* tree = (Quadtree*)g_spatial_alloc(sizeof(Quadtree));
     if (!tree) return NULL;
 
     tree->root = node_create(world_bounds, 0);
@@ -236,7 +273,7 @@ void quadtree_destroy(Quadtree* tree) {
     if (!tree) return;
 
     node_destroy(tree->root);
-    free(tree);
+    g_spatial_free(tree);
 }
 
 void quadtree_clear(Quadtree* tree) {
@@ -249,9 +286,13 @@ void quadtree_clear(Quadtree* tree) {
 }
 
 void quadtree_insert(Quadtree* tree, int entity_index, AABB bounds) {
+    quadtree_insert_with_mass(tree, entity_index, bounds, 1.0f);
+}
+
+void quadtree_insert_with_mass(Quadtree* tree, int entity_index, AABB bounds, float mass) {
     if (!tree || !tree->root) return;
 
-    node_insert(tree->root, entity_index, bounds, QUADTREE_MAX_DEPTH);
+    node_insert(tree->root, (SpatialEntity){entity_index, bounds, mass}, QUADTREE_MAX_DEPTH);
     tree->total_entities++;
 
     // Update stats
@@ -273,6 +314,266 @@ void quadtree_query_callback(Quadtree* tree, AABB query_bounds, QueryCallback ca
     node_query_callback(tree->root, query_bounds, callback, user_data);
 }
 
+// === Barnes-Hut ===
+
+static inline Vector2 entity_center(const SpatialEntity* entity) {
+    return (Vector2){
+        (entity->bounds.x_min + entity->bounds.x_max) * 0.5f,
+        (entity->bounds.y_min + entity->bounds.y_max) * 0.5f
+    };
+}
+
+// Entities are duplicated into every leaf their bounds touch; only the leaf
+// owning the (root-clamped) center counts them. Bounds are half-open except on
+// the root's max edges, so exactly one leaf owns each point.
+static bool node_owns_point(const QuadNode* node, AABB root, Vector2 p) {
+    p.x = p.x < root.x_min ? root.x_min : (p.x > root.x_max ? root.x_max : p.x);
+    p.y = p.y < root.y_min ? root.y_min : (p.y > root.y_max ? root.y_max : p.y);
+
+    const bool in_x = p.x >= node->bounds.x_min &&
+                      (p.x < node->bounds.x_max || (p.x == root.x_max && node->bounds.x_max == root.x_max));
+    const bool in_y = p.y >= node->bounds.y_min &&
+                      (p.y < node->bounds.y_max || (p.y == root.y_max && node->bounds.y_max == root.y_max));
+    return in_x && in_y;
+}
+
+static void node_compute_mass(QuadNode* node, AABB root) {
+    float mass = 0.0f;
+    Vector2 weighted = {0, 0};
+
+    if (node->is_leaf) {
+        const int total = node_entity_total(node);
+        for (int i = 0; i < total; i++) {
+            const SpatialEntity* entity = node_entity_at(node, i);
+            const Vector2 center = entity_center(entity);
+            if (!node_owns_point(node, root, center)) continue;
+
+            mass += entity->mass;
+            weighted.x += center.x * entity->mass;
+            weighted.y += center.y * entity->mass;
+        }
+    } else {
+        for (int i = 0; i < 4; i++) {
+            QuadNode* child = node->children[i];
+            if (!child) continue;
+
+            node_compute_mass(child, root);
+            mass += child->mass;
+            weighted.x += child->center_of_mass.x * child->mass;
+            weighted.y += child->center_of_mass.y * child->mass;
+        }
+    }
+
+    node->mass = mass;
+    node->center_of_mass = mass > 0.0f
+                               ? (Vector2){weighted.x / mass, weighted.y / mass}
+                               : (Vector2){
+                                   (node->bounds.x_min + node->bounds.x_max) * 0.5f,
+                                   (node->bounds.y_min + node->bounds.y_max) * 0.5f
+                               };
+}
+
+// Softened inverse-square pull of a point mass
+static inline void add_attraction(Vector2* acc, Vector2 position, Vector2 source, float mass, float softening_sq) {
+    const float dx = source.x - position.x;
+    const float dy = source.y - position.y;
+    const float dist_sq = dx * dx + dy * dy + softening_sq;
+    const float inv_dist = 1.0f / sqrtf(dist_sq);
+    const float scale = mass * inv_dist * inv_dist * inv_dist;
+    acc->x += dx * scale;
+    acc->y += dy * scale;
+}
+
+static void node_gravity(const QuadNode* node, AABB root, Vector2 position, int self_index,
+                         float theta_sq, float softening_sq, Vector2* acc) {
+    if (!node || node->mass <= 0.0f) return;
+
+    const float size = fmaxf(node->bounds.x_max - node->bounds.x_min, node->bounds.y_max - node->bounds.y_min);
+    const float dx = node->center_of_mass.x - position.x;
+    const float dy = node->center_of_mass.y - position.y;
+    const float dist_sq = dx * dx + dy * dy;
+
+    // Far enough away (and not containing the query point): use the aggregate
+    if (!aabb_contains_point(node->bounds, position) && size * size < theta_sq * dist_sq) {
+        add_attraction(acc, position, node->center_of_mass, node->mass, softening_sq);
+        return;
+    }
+
+    if (node->is_leaf) {
+        const int total = node_entity_total(node);
+        for (int i = 0; i < total; i++) {
+            const SpatialEntity* entity = node_entity_at(node, i);
+            if (entity->index == self_index) continue;
+
+            const Vector2 center = entity_center(entity);
+            if (!node_owns_point(node, root, center)) continue;
+
+            add_attraction(acc, position, center, entity->mass, softening_sq);
+        }
+        return;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        node_gravity(node->children[i], root, position, self_index, theta_sq, softening_sq, acc);
+    }
+}
+
+void quadtree_compute_mass(Quadtree* tree) {
+    if (!tree || !tree->root) return;
+
+    node_compute_mass(tree->root, tree->root->bounds);
+}
+
+Vector2 quadtree_gravity(Quadtree* tree, Vector2 position, int self_index, float theta, float softening) {
+    Vector2 acc = {0, 0};
+    if (!tree || !tree->root) return acc;
+
+    node_gravity(tree->root, tree->root->bounds, position, self_index,
+                 theta * theta, softening * softening, &acc);
+    return acc;
+}
+
+// === Clustered queries ===
+
+typedef struct {
+    int count;
+    int first_index;
+    Vector2 center_sum;
+    float area_sum; // Sum of r^2
+} ClusterSum;
+
+static void node_sum_owned(const QuadNode* node, AABB root, ClusterSum* sum) {
+    if (node->is_leaf) {
+        const int total = node_entity_total(node);
+        for (int i = 0; i < total; i++) {
+            const SpatialEntity* entity = node_entity_at(node, i);
+            const Vector2 center = entity_center(entity);
+            if (!node_owns_point(node, root, center)) continue;
+
+            const float r = (entity->bounds.x_max - entity->bounds.x_min) * 0.5f;
+            if (sum->count == 0) sum->first_index = entity->index;
+            sum->count++;
+            sum->center_sum.x += center.x;
+            sum->center_sum.y += center.y;
+            sum->area_sum += r * r;
+        }
+        return;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        if (node->children[i]) node_sum_owned(node->children[i], root, sum);
+    }
+}
+
+static void node_query_clustered(const QuadNode* node, AABB root, AABB query_bounds, float cluster_size,
+                                 QueryCallback entity_callback, ClusterCallback cluster_callback,
+                                 void* user_data) {
+    if (!node || !aabb_intersects(node->bounds, query_bounds)) return;
+
+    const float size = fmaxf(node->bounds.x_max - node->bounds.x_min, node->bounds.y_max - node->bounds.y_min);
+    if (size <= cluster_size) {
+        ClusterSum sum = {0};
+        node_sum_owned(node, root, &sum);
+        if (sum.count == 1) {
+            entity_callback(sum.first_index, user_data);
+        } else if (sum.count > 1) {
+            const Vector2 centroid = {sum.center_sum.x / sum.count, sum.center_sum.y / sum.count};
+            cluster_callback(centroid, sqrtf(sum.area_sum), sum.count, sum.first_index, user_data);
+        }
+        return;
+    }
+
+    if (node->is_leaf) {
+        const int total = node_entity_total(node);
+        for (int i = 0; i < total; i++) {
+            const SpatialEntity* entity = node_entity_at(node, i);
+            if (node_owns_point(node, root, entity_center(entity))) {
+                entity_callback(entity->index, user_data);
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        node_query_clustered(node->children[i], root, query_bounds, cluster_size,
+                             entity_callback, cluster_callback, user_data);
+    }
+}
+
+void quadtree_query_clustered(Quadtree* tree, AABB query_bounds, float cluster_size,
+                              QueryCallback entity_callback, ClusterCallback cluster_callback, void* user_data) {
+    if (!tree || !tree->root || !entity_callback || !cluster_callback) return;
+
+    node_query_clustered(tree->root, tree->root->bounds, query_bounds, cluster_size,
+                         entity_callback, cluster_callback, user_data);
+}
+
+// === Morton Order ===
+
+// Spread the low 16 bits of x to the even bit positions
+static inline unsigned int morton_spread(unsigned int x) {
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+unsigned int spatial_morton_code(AABB world, Vector2 point) {
+    const float width = world.x_max - world.x_min;
+    const float height = world.y_max - world.y_min;
+    float u = width > 0 ? (point.x - world.x_min) / width : 0.0f;
+    float v = height > 0 ? (point.y - world.y_min) / height : 0.0f;
+    u = u < 0.0f ? 0.0f : (u > 1.0f ? 1.0f : u);
+    v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+
+    const unsigned int x = (unsigned int)(u * 65535.0f);
+    const unsigned int y = (unsigned int)(v * 65535.0f);
+    return morton_spread(x) | (morton_spread(y) << 1);
+}
+
+void spatial_sort_by_code(const unsigned int* codes, int count, int* order) {
+    if (count <= 0) return;
+
+    int* scratch = (int*)g_spatial_alloc(sizeof(int) * count);
+    if (!scratch) return;
+
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+
+    // LSD radix sort, 8 bits per pass; stable so equal codes keep their order
+    int* src = order;
+    int* dst = scratch;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int offsets[257] = {0};
+        for (int i = 0; i < count; i++) {
+            offsets[((codes[src[i]] >> shift) & 0xFF) + 1]++;
+        }
+        for (int b = 0; b < 256; b++) {
+            offsets[b + 1] += offsets[b];
+        }
+        for (int i = 0; i < count; i++) {
+            dst[offsets[(codes[src[i]] >> shift) & 0xFF]++] = src[i];
+        }
+
+        int* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // Four passes: the result is back in order
+    g_spatial_free(scratch);
+}
+
+// === Memory ===
+
+void spatial_set_allocator(SpatialAllocFn alloc_fn, SpatialFreeFn free_fn) {
+    g_spatial_alloc = alloc_fn ? alloc_fn : malloc;
+    g_spatial_free = free_fn ? free_fn : free;
+}
+
 // === Utility Functions ===
 
 AABB aabb_from_circle(Vector2 position, float radius) {
@@ -296,15 +597,14 @@ bool aabb_contains_point(AABB box, Vector2 point) {
 
 // === Debug Visualization ===
 
-// Recursive drawing helper
-static void node_debug_draw_recursive(QuadNode* node, Vector2 screen_center, float zoom) {
-    if (!node) return;
-
+// Draw one node's bounds, and its entity count if it is a non-empty leaf
+static void debug_draw_node(AABB bounds, int depth, int entity_count, Vector2 camera, Vector2 screen_center,
+                            float zoom) {
     // Apply same transformation as entity rendering:
-    // 1. Get offset from screen center for min corner
+    // 1. Get offset from the camera for min corner
     Vector2 min_offset = {
-        node->bounds.x_min - screen_center.x,
-        node->bounds.y_min - screen_center.y
+        bounds.x_min - camera.x,
+        bounds.y_min - camera.y
     };
     Vector2 scaled_min_offset = {min_offset.x * zoom, min_offset.y * zoom};
     Vector2 min_screen = {
@@ -313,8 +613,8 @@ static void node_debug_draw_recursive(QuadNode* node, Vector2 screen_center, flo
     };
 
     // 2. Calculate width/height and scale them
-    float world_width = node->bounds.x_max - node->bounds.x_min;
-    float world_height = node->bounds.y_max - node->bounds.y_min;
+    float world_width = bounds.x_max - bounds.x_min;
+    float world_height = bounds.y_max - bounds.y_min;
     float width = world_width * zoom;
     float height = world_height * zoom;
 
@@ -330,31 +630,93 @@ static void node_debug_draw_recursive(QuadNode* node, Vector2 screen_center, flo
         (Color){255, 0, 0, 40},     // Red (depth 4+)
     };
 
-    int color_index = node->depth < 5 ? node->depth : 4;
+    int color_index = depth < 5 ? depth : 4;
     Color color = colors[color_index];
 
     // Draw node bounds
     DrawRectangleLinesEx((Rectangle){x, y, width, height}, 1.0f, color);
 
     // Draw entity count if leaf
-    if (node->is_leaf && node->entity_count > 0) {
-        DrawText(TextFormat("%d", node->entity_count),
-                 (int)(x + 2), (int)(y + 2), 10, WHITE);
+    if (entity_count > 0) {
+        DrawText(TextFormat("%d", entity_count), (int)(x + 2), (int)(y + 2), 10, WHITE);
     }
+}
+
+static void debug_draw_stats(int node_count, int total_entities, int max_depth_reached) {
+    DrawText(TextFormat("Quadtree: %d nodes, %d entities, depth %d",
+                        node_count, total_entities, max_depth_reached),
+             10, 120, 20, YELLOW);
+}
+
+static int node_debug_entity_count(const QuadNode* node) {
+    return node->is_leaf ? node_entity_total(node) : 0;
+}
+
+// Recursive drawing helper
+static void node_debug_draw_recursive(QuadNode* node, Vector2 camera, Vector2 screen_center, float zoom) {
+    if (!node) return;
+
+    debug_draw_node(node->bounds, node->depth, node_debug_entity_count(node), camera, screen_center, zoom);
 
     // Recursively draw children
     for (int i = 0; i < 4; i++) {
-        node_debug_draw_recursive(node->children[i], screen_center, zoom);
+        node_debug_draw_recursive(node->children[i], camera, screen_center, zoom);
     }
 }
 
-void quadtree_debug_draw(Quadtree* tree, Vector2 screen_center, float zoom) {
+void quadtree_debug_draw(Quadtree* tree, Vector2 camera, Vector2 screen_center, float zoom) {
     if (!tree || !tree->root) return;
 
-    node_debug_draw_recursive(tree->root, screen_center, zoom);
+    node_debug_draw_recursive(tree->root, camera, screen_center, zoom);
+    debug_draw_stats(tree->node_count, tree->total_entities, tree->max_depth_reached);
+}
 
-    // Draw stats
-    DrawText(TextFormat("Quadtree: %d nodes, %d entities, depth %d",
-                        tree->node_count, tree->total_entities, tree->max_depth_reached),
-             10, 120, 20, YELLOW);
+// Append node and its subtree in drawing order
+static void node_debug_capture_recursive(const QuadNode* node, QuadtreeDebugSnapshot* snapshot) {
+    if (!node) return;
+
+    if (snapshot->count == snapshot->capacity) {
+        int capacity = snapshot->capacity ? snapshot->capacity * 2 : 64;
+        QuadtreeDebugNode* grown = (QuadtreeDebugNode*)g_spatial_alloc(sizeof(QuadtreeDebugNode) * capacity);
+        if (!grown) return;
+        if (snapshot->nodes) {
+            memcpy(grown, snapshot->nodes, sizeof(QuadtreeDebugNode) * snapshot->count);
+            g_spatial_free(snapshot->nodes);
+        }
+        snapshot->nodes = grown;
+        snapshot->capacity = capacity;
+    }
+    snapshot->nodes[snapshot->count++] = (QuadtreeDebugNode){
+        .bounds = node->bounds,
+        .depth = node->depth,
+        .entity_count = node_debug_entity_count(node)
+    };
+
+    for (int i = 0; i < 4; i++) {
+        node_debug_capture_recursive(node->children[i], snapshot);
+    }
+}
+
+void quadtree_debug_capture(const Quadtree* tree, QuadtreeDebugSnapshot* snapshot) {
+    snapshot->count = 0;
+    snapshot->node_count = tree ? tree->node_count : 0;
+    snapshot->total_entities = tree ? tree->total_entities : 0;
+    snapshot->max_depth_reached = tree ? tree->max_depth_reached : 0;
+    if (tree) node_debug_capture_recursive(tree->root, snapshot);
+}
+
+void quadtree_debug_draw_snapshot(const QuadtreeDebugSnapshot* snapshot, Vector2 camera,
+                                  Vector2 screen_center, float zoom) {
+    if (snapshot->count == 0) return;
+
+    for (int i = 0; i < snapshot->count; i++) {
+        const QuadtreeDebugNode* node = &snapshot->nodes[i];
+        debug_draw_node(node->bounds, node->depth, node->entity_count, camera, screen_center, zoom);
+    }
+    debug_draw_stats(snapshot->node_count, snapshot->total_entities, snapshot->max_depth_reached);
+}
+
+void quadtree_debug_snapshot_free(QuadtreeDebugSnapshot* snapshot) {
+    if (snapshot->nodes) g_spatial_free(snapshot->nodes);
+    *snapshot = (QuadtreeDebugSnapshot){0};
 }
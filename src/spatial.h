@@ -2,6 +2,7 @@
 #define SPATIAL_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <raylib.h>
 
 // Maximum entities stored in array per node before subdivision
@@ -22,6 +23,7 @@ typedef struct {
 typedef struct {
     int index;       // Index into the entity array
     AABB bounds;     // Cached bounding box
+    float mass;      // Weight for Barnes-Hut aggregation (1 unless inserted with a mass)
 } SpatialEntity;
 
 // Quadtree node (recursive structure)
@@ -30,8 +32,13 @@ typedef struct QuadNode {
     struct QuadNode* children[4];          // NW, NE, SW, SE children (NULL if leaf)
     SpatialEntity entities[QUADTREE_NODE_CAPACITY]; // Entities in this node
     int entity_count;                      // Number of entities in this node
+    SpatialEntity* overflow;               // Entities beyond capacity in a leaf at max depth
+    int overflow_count;
+    int overflow_capacity;
     int depth;                             // Depth in the tree (root = 0)
     bool is_leaf;                          // True if this node has no children
+    float mass;                            // Aggregate mass (see quadtree_compute_mass)
+    Vector2 center_of_mass;                // Mass-weighted centroid of the node's entities
 } QuadNode;
 
 // Quadtree spatial partitioning structure
@@ -48,6 +55,15 @@ typedef struct {
 // Parameters: entity_index, user_data
 typedef void (*QueryCallback)(int entity_index, void* user_data);
 
+// Called for a group of entities reported as one (see quadtree_query_clustered):
+// the centroid of their centers, the radius of a circle as large as all of them
+// together, how many there are and the index of one of them
+typedef void (*ClusterCallback)(Vector2 centroid, float radius, int count, int first_index, void* user_data);
+
+// Allocation hooks for quadtree memory (defaults to malloc/free)
+typedef void* (*SpatialAllocFn)(size_t size);
+typedef void (*SpatialFreeFn)(void* ptr);
+
 // === Lifecycle ===
 
 // Create a new quadtree with the given world bounds
@@ -66,6 +82,9 @@ void quadtree_clear(Quadtree* tree);
 // bounds: The AABB of the entity
 void quadtree_insert(Quadtree* tree, int entity_index, AABB bounds);
 
+// Insert with an explicit mass for Barnes-Hut aggregation (quadtree_insert uses 1)
+void quadtree_insert_with_mass(Quadtree* tree, int entity_index, AABB bounds, float mass);
+
 // === Queries ===
 
 // Query all entities that intersect with the given AABB
@@ -77,6 +96,35 @@ int quadtree_query(Quadtree* tree, AABB query_bounds, int* results, int max_resu
 // Query with callback (more flexible, avoids allocation)
 void quadtree_query_callback(Quadtree* tree, AABB query_bounds, QueryCallback callback, void* user_data);
 
+// Query for drawing at a distance: nodes intersecting query_bounds that are no
+// larger than cluster_size are reported as one cluster instead of their entities.
+// Each entity is reported once, from the leaf owning its center (unlike the
+// queries above, which report every entity whose bounds intersect).
+void quadtree_query_clustered(Quadtree* tree, AABB query_bounds, float cluster_size,
+                              QueryCallback entity_callback, ClusterCallback cluster_callback, void* user_data);
+
+// === Barnes-Hut ===
+
+// Aggregate mass and center of mass bottom-up over the current contents.
+// Call after all inserts; each entity counts once, in the leaf owning its center.
+void quadtree_compute_mass(Quadtree* tree);
+
+// Approximate sum of m * (c - position) / (|c - position|^2 + softening^2)^(3/2)
+// over all entities except self_index, i.e. the acceleration from unit-strength
+// gravity. Nodes whose size/distance ratio is below theta are treated as a single
+// body at their center of mass (theta = 0 gives the exact O(n) sum).
+Vector2 quadtree_gravity(Quadtree* tree, Vector2 position, int self_index, float theta, float softening);
+
+// === Morton Order ===
+
+// Z-order curve code of a point: 16 bits per axis across world, interleaved.
+// Points outside world are clamped to its edges.
+unsigned int spatial_morton_code(AABB world, Vector2 point);
+
+// Stable sort of indices 0 .. count - 1 by codes[index].
+// order: count entries out; order[k] is the index with the k-th smallest code
+void spatial_sort_by_code(const unsigned int* codes, int count, int* order);
+
 // === Utilities ===
 
 // Create an AABB from a circle (position + radius)
@@ -88,11 +136,44 @@ bool aabb_intersects(AABB a, AABB b);
 // Check if an AABB contains a point
 bool aabb_contains_point(AABB box, Vector2 point);
 
+// === Memory ===
+
+// Route all quadtree allocations through alloc_fn/free_fn (NULL restores malloc/free).
+// Must not be changed while trees allocated with the previous functions are alive.
+void spatial_set_allocator(SpatialAllocFn alloc_fn, SpatialFreeFn free_fn);
+
 // === Debug Visualization ===
 
 // Draw the quadtree structure (for debugging)
+// camera: The world point drawn at the screen center
 // screen_center: The screen center point (for proper zoom rendering)
 // zoom: The current zoom level
-void quadtree_debug_draw(Quadtree* tree, Vector2 screen_center, float zoom);
+void quadtree_debug_draw(Quadtree* tree, Vector2 camera, Vector2 screen_center, float zoom);
+
+// Copy of the tree's node bounds, for drawing the structure after the tree has
+// been rebuilt (by a simulation running ahead of the renderer)
+typedef struct {
+    AABB bounds;
+    int depth;
+    int entity_count;  // Entities in a leaf (0 for inner nodes)
+} QuadtreeDebugNode;
+
+typedef struct {
+    QuadtreeDebugNode* nodes;
+    int count;
+    int capacity;
+    int node_count;
+    int total_entities;
+    int max_depth_reached;
+} QuadtreeDebugSnapshot;
+
+// Fill snapshot with the current nodes of tree (empty if tree is NULL), reusing its storage
+void quadtree_debug_capture(const Quadtree* tree, QuadtreeDebugSnapshot* snapshot);
+
+// Same drawing as quadtree_debug_draw, from a snapshot
+void quadtree_debug_draw_snapshot(const QuadtreeDebugSnapshot* snapshot, Vector2 camera,
+                                  Vector2 screen_center, float zoom);
+
+void quadtree_debug_snapshot_free(QuadtreeDebugSnapshot* snapshot);
 
 #endif // SPATIAL_H
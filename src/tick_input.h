@@ -0,0 +1,25 @@
+#ifndef TICK_INPUT_H
+#define TICK_INPUT_H
+
+// Per-tick input, decoupled from the keyboard so the simulation can run headless.
+// Kept apart from game.h so replay I/O builds without flecs.
+
+typedef enum {
+    INPUT_RIGHT = 1 << 0,
+    INPUT_LEFT = 1 << 1,
+    INPUT_UP = 1 << 2,
+    INPUT_DOWN = 1 << 3,
+    INPUT_ATTRACT = 1 << 4,       // Held: player attracts enemies
+    INPUT_SPAWN = 1 << 5,         // Held: spawn one enemy per tick, sent out in batches
+    INPUT_CYCLE_PHYSICS = 1 << 6, // Pressed: switch to the next Physics mode
+    INPUT_SPAWN_WAVE = 1 << 7     // Pressed: spawn ENEMY_WAVE_SIZE enemies at once
+} InputButton;
+
+typedef struct {
+    unsigned int buttons; // InputButton flags
+    float dt;             // Seconds to advance
+    int screenWidth;      // Arena size when no world size is set; the arena is then
+    int screenHeight;     // the zoom-adjusted screen
+} TickInput;
+
+#endif // TICK_INPUT_H
@@ -0,0 +1,328 @@
+#include "tween.h"
+#include <math.h>
+#include <string.h>
+#include "memtrack.h"
+
+// Handles: slot index + 1 in the low bits, slot generation in the high bits
+#define TWEEN_INDEX_BITS 20
+#define TWEEN_INDEX_MASK ((1u << TWEEN_INDEX_BITS) - 1)
+#define TWEEN_GENERATION_MASK (0xFFFFFFFFu >> TWEEN_INDEX_BITS)
+
+static TweenHandle make_handle(uint32_t slot, uint32_t generation) {
+    return ((generation & TWEEN_GENERATION_MASK) << TWEEN_INDEX_BITS) | (slot + 1);
+}
+
+// Slot of a running spring, or -1 for stale and empty handles
+static int handle_slot(const TweenPool* pool, TweenHandle handle) {
+    const uint32_t index = handle & TWEEN_INDEX_MASK;
+    if (index == 0 || index > (uint32_t)pool->slot_count) return -1;
+
+    const TweenSlot* slot = &pool->slots[index - 1];
+    if ((slot->generation & TWEEN_GENERATION_MASK) != handle >> TWEEN_INDEX_BITS) return -1;
+    if (slot->dense >= (uint32_t)pool->count || pool->slot[slot->dense] != index - 1) return -1;
+    return (int)(index - 1);
+}
+
+static bool reserve_dense(TweenPool* pool, int count) {
+    if (count <= pool->capacity) return true;
+
+    int capacity = pool->capacity ? pool->capacity : 64;
+    while (capacity < count) capacity *= 2;
+
+    float* value = memtrack_realloc(MEMTRACK_ANIMATION, pool->value, sizeof(float) * capacity);
+    if (value) pool->value = value;
+    float* velocity = memtrack_realloc(MEMTRACK_ANIMATION, pool->velocity, sizeof(float) * capacity);
+    if (velocity) pool->velocity = velocity;
+    float* target = memtrack_realloc(MEMTRACK_ANIMATION, pool->target, sizeof(float) * capacity);
+    if (target) pool->target = target;
+    uint8_t* profile = memtrack_realloc(MEMTRACK_ANIMATION, pool->profile, sizeof(uint8_t) * capacity);
+    if (profile) pool->profile = profile;
+    uint64_t* owner = memtrack_realloc(MEMTRACK_ANIMATION, pool->owner, sizeof(uint64_t) * capacity);
+    if (owner) pool->owner = owner;
+    uint32_t* slot = memtrack_realloc(MEMTRACK_ANIMATION, pool->slot, sizeof(uint32_t) * capacity);
+    if (slot) pool->slot = slot;
+
+    if (!value || !velocity || !target || !profile || !owner || !slot) return false;
+    pool->capacity = capacity;
+    return true;
+}
+
+static bool reserve_slots(TweenPool* pool, int count) {
+    if (count <= pool->slot_capacity) return true;
+
+    int capacity = pool->slot_capacity ? pool->slot_capacity : 64;
+    while (capacity < count) capacity *= 2;
+    TweenSlot* slots = memtrack_realloc(MEMTRACK_ANIMATION, pool->slots, sizeof(TweenSlot) * capacity);
+    if (!slots) return false;
+    pool->slots = slots;
+    pool->slot_capacity = capacity;
+    return true;
+}
+
+// Move the last spring into dense index i, dropping the one there
+static void remove_dense(TweenPool* pool, int i) {
+    TweenSlot* removed = &pool->slots[pool->slot[i]];
+    removed->generation++;
+    removed->dense = pool->free_head;
+    pool->free_head = pool->slot[i] + 1;
+
+    const int last = --pool->count;
+    if (i != last) {
+        pool->value[i] = pool->value[last];
+        pool->velocity[i] = pool->velocity[last];
+        pool->target[i] = pool->target[last];
+        pool->profile[i] = pool->profile[last];
+        pool->owner[i] = pool->owner[last];
+        pool->slot[i] = pool->slot[last];
+        pool->slots[pool->slot[i]].dense = (uint32_t)i;
+    }
+}
+
+// === Lifecycle ===
+
+void tween_pool_free(TweenPool* pool) {
+    memtrack_free(pool->value);
+    memtrack_free(pool->velocity);
+    memtrack_free(pool->target);
+    memtrack_free(pool->profile);
+    memtrack_free(pool->owner);
+    memtrack_free(pool->slot);
+    memtrack_free(pool->slots);
+    memtrack_free(pool->finished);
+    memset(pool, 0, sizeof(*pool));
+}
+
+void tween_pool_clear(TweenPool* pool) {
+    while (pool->count > 0) {
+        remove_dense(pool, pool->count - 1);
+    }
+    pool->finished_count = 0;
+}
+
+// === Springs ===
+
+int tween_profile(TweenPool* pool, float stiffness, float damping) {
+    for (int p = 0; p < pool->profile_count; p++) {
+        if (pool->profiles[p].stiffness == stiffness && pool->profiles[p].damping == damping) return p;
+    }
+    if (pool->profile_count == TWEEN_MAX_PROFILES) return -1;
+
+    pool->profiles[pool->profile_count] = (TweenProfile){stiffness, damping};
+    return pool->profile_count++;
+}
+
+TweenHandle tween_start(TweenPool* pool, int profile, uint64_t owner, float value, float velocity, float target) {
+    if (profile < 0 || profile >= pool->profile_count) return 0;
+    if (!reserve_dense(pool, pool->count + 1)) return 0;
+
+    uint32_t index;
+    if (pool->free_head != 0) {
+        index = pool->free_head - 1;
+        pool->free_head = pool->slots[index].dense;
+    } else {
+        if (pool->slot_count == (int)TWEEN_INDEX_MASK || !reserve_slots(pool, pool->slot_count + 1)) return 0;
+        index = (uint32_t)pool->slot_count++;
+        pool->slots[index].generation = 0;
+    }
+
+    const int i = pool->count++;
+    pool->value[i] = value;
+    pool->velocity[i] = velocity;
+    pool->target[i] = target;
+    pool->profile[i] = (uint8_t)profile;
+    pool->owner[i] = owner;
+    pool->slot[i] = index;
+    pool->slots[index].dense = (uint32_t)i;
+    return make_handle(index, pool->slots[index].generation);
+}
+
+// Generations wrap, so a long-stale handle can match again: the owner must match too
+static int owned_slot(const TweenPool* pool, TweenHandle handle, uint64_t owner) {
+    const int slot = handle_slot(pool, handle);
+    return slot >= 0 && pool->owner[pool->slots[slot].dense] == owner ? slot : -1;
+}
+
+void tween_stop(TweenPool* pool, TweenHandle handle, uint64_t owner) {
+    const int slot = owned_slot(pool, handle, owner);
+    if (slot >= 0) remove_dense(pool, (int)pool->slots[slot].dense);
+}
+
+bool tween_running(const TweenPool* pool, TweenHandle handle, uint64_t owner) {
+    return owned_slot(pool, handle, owner) >= 0;
+}
+
+// Exact step of y'' = -k y - c y' over dt, as a matrix over (y, y')
+typedef struct {
+    float m00, m01, m10, m11;
+} SpringStep;
+
+static SpringStep spring_step(TweenProfile profile, float dt) {
+    const double k = profile.stiffness;
+    const double a = profile.damping * 0.5; // Decay rate of the envelope
+    const double t = dt;
+    const double decay = exp(-a * t);
+    const double disc = k - a * a;
+
+    double c, s; // cos(wt) and sin(wt)/w, or their hyperbolic / critical limits
+    if (fabs(disc) < 1e-6 * (k + a * a)) {
+        c = 1.0;
+        s = t;
+    } else if (disc > 0) {
+        const double w = sqrt(disc);
+        c = cos(w * t);
+        s = sin(w * t) / w;
+    } else {
+        const double w = sqrt(-disc);
+        c = cosh(w * t);
+        s = sinh(w * t) / w;
+    }
+
+    return (SpringStep){
+        .m00 = (float)(decay * (c + a * s)),
+        .m01 = (float)(decay * s),
+        .m10 = (float)(-decay * k * s),
+        .m11 = (float)(decay * (c - a * s))
+    };
+}
+
+static void push_finished(TweenPool* pool, uint64_t owner, float value) {
+    if (pool->finished_count == pool->finished_capacity) {
+        const int capacity = pool->finished_capacity ? pool->finished_capacity * 2 : 64;
+        TweenFinished* finished = memtrack_realloc(MEMTRACK_ANIMATION, pool->finished, sizeof(TweenFinished) * capacity);
+        if (!finished) return;
+        pool->finished = finished;
+        pool->finished_capacity = capacity;
+    }
+    pool->finished[pool->finished_count++] = (TweenFinished){owner, value};
+}
+
+void tween_update(TweenPool* pool, float dt) {
+    pool->finished_count = 0;
+
+    SpringStep steps[TWEEN_MAX_PROFILES];
+    for (int p = 0; p < pool->profile_count; p++) {
+        steps[p] = spring_step(pool->profiles[p], dt);
+    }
+
+    int i = 0;
+    while (i < pool->count) {
+        const SpringStep* m = &steps[pool->profile[i]];
+        const float y = pool->value[i] - pool->target[i];
+        const float v = pool->velocity[i];
+        const float next_y = m->m00 * y + m->m01 * v;
+        const float next_v = m->m10 * y + m->m11 * v;
+
+        if (fabsf(next_y) < TWEEN_REST_DISTANCE && fabsf(next_v) < TWEEN_REST_SPEED) {
+            // The last spring moves into i and is stepped next
+            push_finished(pool, pool->owner[i], pool->target[i]);
+            remove_dense(pool, i);
+            continue;
+        }
+
+        pool->value[i] = pool->target[i] + next_y;
+        pool->velocity[i] = next_v;
+        i++;
+    }
+}
+
+// === Snapshots ===
+
+// Layout: counts, profiles, slots, then the dense columns widest first, so every
+// column stays aligned when the blob is
+typedef struct {
+    uint32_t count;
+    uint32_t slot_count;
+    uint32_t free_head;
+    uint32_t profile_count;
+} TweenPoolHeader;
+
+static size_t saved_size(uint32_t count, uint32_t slot_count, uint32_t profile_count) {
+    return sizeof(TweenPoolHeader) + sizeof(TweenProfile) * profile_count + sizeof(TweenSlot) * slot_count +
+           (sizeof(uint64_t) + sizeof(float) * 3 + sizeof(uint32_t) + sizeof(uint8_t)) * count;
+}
+
+size_t tween_pool_save(const TweenPool* pool, void* out) {
+    const TweenPoolHeader header = {
+        (uint32_t)pool->count, (uint32_t)pool->slot_count, pool->free_head, (uint32_t)pool->profile_count
+    };
+    const size_t size = saved_size(header.count, header.slot_count, header.profile_count);
+    if (!out) return size;
+
+    unsigned char* cursor = out;
+#define TWEEN_SAVE(src, bytes) (memcpy(cursor, (src), (bytes)), cursor += (bytes))
+    TWEEN_SAVE(&header, sizeof(header));
+    TWEEN_SAVE(pool->profiles, sizeof(TweenProfile) * pool->profile_count);
+    TWEEN_SAVE(pool->slots, sizeof(TweenSlot) * pool->slot_count);
+    TWEEN_SAVE(pool->owner, sizeof(uint64_t) * pool->count);
+    TWEEN_SAVE(pool->value, sizeof(float) * pool->count);
+    TWEEN_SAVE(pool->velocity, sizeof(float) * pool->count);
+    TWEEN_SAVE(pool->target, sizeof(float) * pool->count);
+    TWEEN_SAVE(pool->slot, sizeof(uint32_t) * pool->count);
+    TWEEN_SAVE(pool->profile, sizeof(uint8_t) * pool->count);
+#undef TWEEN_SAVE
+    return size;
+}
+
+bool tween_pool_load(TweenPool* pool, const void* data, size_t size) {
+    TweenPoolHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.profile_count > TWEEN_MAX_PROFILES || header.slot_count > TWEEN_INDEX_MASK ||
+        header.count > header.slot_count || header.free_head > header.slot_count ||
+        size != saved_size(header.count, header.slot_count, header.profile_count)) {
+        return false;
+    }
+
+    const unsigned char* cursor = (const unsigned char*)data + sizeof(header);
+    const TweenProfile* profiles = (const void*)cursor;
+    cursor += sizeof(TweenProfile) * header.profile_count;
+    const unsigned char* slots = cursor;
+    cursor += sizeof(TweenSlot) * header.slot_count;
+    const unsigned char* owner = cursor;
+    cursor += sizeof(uint64_t) * header.count;
+    const unsigned char* value = cursor;
+    cursor += sizeof(float) * header.count;
+    const unsigned char* velocity = cursor;
+    cursor += sizeof(float) * header.count;
+    const unsigned char* target = cursor;
+    cursor += sizeof(float) * header.count;
+    const unsigned char* dense_slot = cursor;
+    cursor += sizeof(uint32_t) * header.count;
+    const uint8_t* profile = cursor;
+
+    // Every running spring's slot points back at it, every profile exists, and the
+    // free list covers exactly the remaining slots
+    for (uint32_t i = 0; i < header.count; i++) {
+        uint32_t s;
+        TweenSlot slot;
+        memcpy(&s, dense_slot + sizeof(uint32_t) * i, sizeof(s));
+        if (s >= header.slot_count || profile[i] >= header.profile_count) return false;
+        memcpy(&slot, slots + sizeof(TweenSlot) * s, sizeof(slot));
+        if (slot.dense != i) return false;
+    }
+    uint32_t free_count = 0;
+    for (uint32_t next = header.free_head; next != 0; free_count++) {
+        if (free_count == header.slot_count || next > header.slot_count) return false;
+        TweenSlot slot;
+        memcpy(&slot, slots + sizeof(TweenSlot) * (next - 1), sizeof(slot));
+        next = slot.dense;
+    }
+    if (free_count + header.count != header.slot_count) return false;
+
+    if (!reserve_dense(pool, (int)header.count) || !reserve_slots(pool, (int)header.slot_count)) return false;
+
+    memcpy(pool->profiles, profiles, sizeof(TweenProfile) * header.profile_count);
+    memcpy(pool->slots, slots, sizeof(TweenSlot) * header.slot_count);
+    memcpy(pool->owner, owner, sizeof(uint64_t) * header.count);
+    memcpy(pool->value, value, sizeof(float) * header.count);
+    memcpy(pool->velocity, velocity, sizeof(float) * header.count);
+    memcpy(pool->target, target, sizeof(float) * header.count);
+    memcpy(pool->slot, dense_slot, sizeof(uint32_t) * header.count);
+    memcpy(pool->profile, profile, sizeof(uint8_t) * header.count);
+    pool->count = (int)header.count;
+    pool->slot_count = (int)header.slot_count;
+    pool->free_head = header.free_head;
+    pool->profile_count = (int)header.profile_count;
+    pool->finished_count = 0;
+    return true;
+}
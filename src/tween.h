@@ -0,0 +1,106 @@
+#ifndef TWEEN_H
+#define TWEEN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Spring tweens: a pool of damped springs, each driving one float (a radius).
+//
+// Running springs are packed in structure-of-arrays storage, so an update is one
+// linear pass. Callers hold handles (slot index + generation): a handle stays
+// valid while its spring runs and goes stale once the spring comes to rest or is
+// stopped, so nothing has to be told when an animation ends.
+//
+// Each spring follows x'' = -stiffness (x - target) - damping x'. For a given dt
+// the exact solution is a fixed 2x2 matrix over (x - target, x'). Springs share a
+// few profiles, and each profile's matrix is computed once per update, so
+// stepping a spring is four multiply-adds with no transcendental calls.
+
+#define TWEEN_MAX_PROFILES 8
+
+// A spring is at rest (and finishes at its target) within these
+#define TWEEN_REST_DISTANCE 0.1f
+#define TWEEN_REST_SPEED 0.1f
+
+typedef uint32_t TweenHandle; // 0 = none
+
+typedef struct {
+    float stiffness; // 1/s^2
+    float damping;   // 1/s; a speed decaying by factor d per second has damping -ln(d)
+} TweenProfile;
+
+// Slot behind a handle: its spring's dense index, or the next free slot
+typedef struct {
+    uint32_t dense;
+    uint32_t generation;
+} TweenSlot;
+
+// A spring that came to rest in the last update
+typedef struct {
+    uint64_t owner;
+    float value;
+} TweenFinished;
+
+typedef struct {
+    // Running springs, dense
+    float* value;
+    float* velocity;
+    float* target;
+    uint8_t* profile;
+    uint64_t* owner;  // Caller's id for each spring (an entity)
+    uint32_t* slot;   // Dense index -> slot
+    int count;
+    int capacity;
+
+    TweenSlot* slots;
+    int slot_count;
+    int slot_capacity;
+    uint32_t free_head; // Slot index + 1, 0 = none
+
+    TweenProfile profiles[TWEEN_MAX_PROFILES];
+    int profile_count;
+
+    TweenFinished* finished; // Of the last update
+    int finished_count;
+    int finished_capacity;
+} TweenPool;
+
+// === Lifecycle ===
+
+// Zero-initialized pools are valid; storage grows on demand and is kept for reuse
+void tween_pool_free(TweenPool* pool);
+
+// Stop every spring; handles handed out so far go stale
+void tween_pool_clear(TweenPool* pool);
+
+// === Springs ===
+
+// Index of the profile with these parameters, added if new. -1 if the table is full.
+int tween_profile(TweenPool* pool, float stiffness, float damping);
+
+// Start a spring at value, moving at velocity, pulled towards target. Returns 0
+// if out of memory or profile is invalid.
+TweenHandle tween_start(TweenPool* pool, int profile, uint64_t owner, float value, float velocity, float target);
+
+// Stop a running spring where it is. Stale handles, and handles whose spring
+// belongs to another owner (after the generation wrapped), are ignored.
+void tween_stop(TweenPool* pool, TweenHandle handle, uint64_t owner);
+
+bool tween_running(const TweenPool* pool, TweenHandle handle, uint64_t owner);
+
+// Advance every spring by dt. Springs coming to rest snap to their target, stop,
+// and are listed in finished; the others leave their value in value[0 .. count).
+void tween_update(TweenPool* pool, float dt);
+
+// === Snapshots ===
+
+// Copy the pool's state (not the finished list) into out; returns the bytes needed.
+// Pass out = NULL to just size it.
+size_t tween_pool_save(const TweenPool* pool, void* out);
+
+// Replace the pool's state with one from tween_pool_save. Returns false, leaving
+// the pool untouched, if the data is malformed or memory runs out.
+bool tween_pool_load(TweenPool* pool, const void* data, size_t size);
+
+#endif // TWEEN_H
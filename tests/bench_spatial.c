@@ -0,0 +1,333 @@
+// Spatial module microbenchmarks (test_runner --bench).
+// Times quadtree_create/insert/clear/query/query_callback over several sizes and
+// distributions, counts allocations through spatial_set_allocator, and checks
+// query results against a brute-force oracle. Output is CSV, one row per op.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "spatial.h"
+
+#define BENCH_ENTITY_RADIUS 15.0f
+#define BENCH_CREATE_REPS 1000
+#define BENCH_MIN_OPS 100000      // Repeat small sizes until at least this many ops
+#define BENCH_ORACLE_QUERIES 10000 // Oracle checks at most this many queries per run
+
+typedef enum {
+	BENCH_UNIFORM,
+	BENCH_CLUSTERED,
+	BENCH_DEGENERATE,
+	BENCH_DISTRIBUTION_COUNT
+} BenchDistribution;
+
+static const char* distribution_names[BENCH_DISTRIBUTION_COUNT] = {
+	"uniform", "clustered", "degenerate"
+};
+
+static const int bench_sizes[] = {1000, 10000, 100000};
+
+typedef struct {
+	long allocs;
+	long frees;
+} AllocStats;
+
+static AllocStats alloc_stats;
+
+static void* bench_alloc(size_t size) {
+	alloc_stats.allocs++;
+	return malloc(size);
+}
+
+static void bench_free(void* ptr) {
+	if (ptr) alloc_stats.frees++;
+	free(ptr);
+}
+
+typedef struct {
+	int checked;
+	long missed;     // In the oracle but not returned by the tree
+	long extra;      // Returned by the tree but not in the oracle
+	long duplicates; // Same entity reported more than once by a single query
+} OracleStats;
+
+static double now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static unsigned int bench_random(unsigned int* state) {
+	unsigned int x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+static float bench_random_range(unsigned int* state, float min, float max) {
+	return min + (max - min) * ((float)(bench_random(state) & 0xFFFFFF) / (float)0xFFFFFF);
+}
+
+// World grows with n so that density stays comparable to a busy game frame
+static float world_side(int n) {
+	return sqrtf((float)n * 4.0f * (2.0f * BENCH_ENTITY_RADIUS) * (2.0f * BENCH_ENTITY_RADIUS));
+}
+
+static void generate(AABB* bounds, int n, BenchDistribution dist, float side) {
+	unsigned int seed = 0x9E3779B9u ^ (unsigned int)n;
+	const float r = BENCH_ENTITY_RADIUS;
+
+	if (dist == BENCH_DEGENERATE) {
+		for (int i = 0; i < n; i++) {
+			bounds[i] = aabb_from_circle((Vector2){side * 0.3f, side * 0.3f}, r);
+		}
+		return;
+	}
+
+	if (dist == BENCH_CLUSTERED) {
+		enum { CLUSTER_COUNT = 16 };
+		const float spread = side / 32.0f;
+		Vector2 centers[CLUSTER_COUNT];
+		for (int c = 0; c < CLUSTER_COUNT; c++) {
+			centers[c] = (Vector2){
+				bench_random_range(&seed, spread + r, side - spread - r),
+				bench_random_range(&seed, spread + r, side - spread - r)
+			};
+		}
+		for (int i = 0; i < n; i++) {
+			Vector2 c = centers[i % CLUSTER_COUNT];
+			c.x += bench_random_range(&seed, -spread, spread);
+			c.y += bench_random_range(&seed, -spread, spread);
+			bounds[i] = aabb_from_circle(c, r);
+		}
+		return;
+	}
+
+	for (int i = 0; i < n; i++) {
+		Vector2 p = {
+			bench_random_range(&seed, r, side - r),
+			bench_random_range(&seed, r, side - r)
+		};
+		bounds[i] = aabb_from_circle(p, r);
+	}
+}
+
+// Counts up to capacity, like quadtree_query, so the totals of both can be compared
+typedef struct {
+	int count;
+	int capacity;
+} CountContext;
+
+static void count_callback(int entity_index, void* user_data) {
+	(void)entity_index;
+	CountContext* ctx = user_data;
+	if (ctx->count < ctx->capacity) ctx->count++;
+}
+
+typedef struct {
+	int* results;
+	int count;
+	int capacity;
+} CollectContext;
+
+static void collect_callback(int entity_index, void* user_data) {
+	CollectContext* ctx = user_data;
+	if (ctx->count < ctx->capacity) {
+		ctx->results[ctx->count++] = entity_index;
+	}
+}
+
+// Compare one query result list against the brute-force answer.
+// marks: per-entity scratch, all zero on entry and on return.
+static void oracle_check(const AABB* bounds, int n, AABB query, const int* results, int count,
+                         unsigned char* marks, OracleStats* stats) {
+	for (int k = 0; k < count; k++) {
+		if (marks[results[k]]) {
+			stats->duplicates++;
+		}
+		marks[results[k]] = 1;
+	}
+
+	for (int j = 0; j < n; j++) {
+		const bool expected = aabb_intersects(bounds[j], query);
+		if (expected && !marks[j]) stats->missed++;
+		if (!expected && marks[j]) stats->extra++;
+	}
+
+	for (int k = 0; k < count; k++) {
+		marks[results[k]] = 0;
+	}
+	stats->checked++;
+}
+
+static void print_row(FILE* out, const char* op, BenchDistribution dist, int n, int reps,
+                      double ns_per_op, double allocs_per_op, const Quadtree* tree,
+                      const OracleStats* oracle) {
+	static const OracleStats none = {0};
+	if (!oracle) oracle = &none;
+	fprintf(out, "%s,%s,%d,%d,%.1f,%.3f,%d,%d,%d,%ld,%ld,%ld\n",
+	        op, distribution_names[dist], n, reps, ns_per_op, allocs_per_op,
+	        tree ? tree->node_count : 0, tree ? tree->max_depth_reached : 0,
+	        oracle->checked, oracle->missed, oracle->extra, oracle->duplicates);
+}
+
+static void bench_create(FILE* out) {
+	static Quadtree* trees[BENCH_CREATE_REPS];
+	const AABB world = {0, 0, 1000, 1000};
+
+	alloc_stats = (AllocStats){0};
+	double t0 = now_ns();
+	for (int i = 0; i < BENCH_CREATE_REPS; i++) {
+		trees[i] = quadtree_create(world);
+	}
+	double t1 = now_ns();
+	const long create_allocs = alloc_stats.allocs;
+
+	for (int i = 0; i < BENCH_CREATE_REPS; i++) {
+		quadtree_destroy(trees[i]);
+	}
+
+	print_row(out, "create", BENCH_UNIFORM, 0, BENCH_CREATE_REPS,
+	          (t1 - t0) / BENCH_CREATE_REPS, (double)create_allocs / BENCH_CREATE_REPS, NULL, NULL);
+}
+
+static void bench_size(FILE* out, BenchDistribution dist, int n) {
+	const float side = world_side(n);
+	const AABB world = {0, 0, side, side};
+	AABB* bounds = malloc(sizeof(AABB) * n);
+	int* results = malloc(sizeof(int) * n * 4);
+	generate(bounds, n, dist, side);
+
+	const int reps = n >= BENCH_MIN_OPS ? 1 : BENCH_MIN_OPS / n;
+	Quadtree* tree = NULL;
+	double insert_ns = 0, clear_ns = 0;
+	long insert_allocs = 0, clear_frees = 0;
+	int clears = 0;
+
+	// Insert (and clear every rep except the last, whose tree serves the queries)
+	for (int rep = 0; rep < reps; rep++) {
+		tree = quadtree_create(world);
+
+		alloc_stats = (AllocStats){0};
+		double t0 = now_ns();
+		for (int i = 0; i < n; i++) {
+			quadtree_insert(tree, i, bounds[i]);
+		}
+		insert_ns += now_ns() - t0;
+		insert_allocs += alloc_stats.allocs;
+
+		if (rep < reps - 1) {
+			alloc_stats = (AllocStats){0};
+			t0 = now_ns();
+			quadtree_clear(tree);
+			clear_ns += now_ns() - t0;
+			clear_frees += alloc_stats.frees;
+			clears++;
+			quadtree_destroy(tree);
+		}
+	}
+	print_row(out, "insert", dist, n, reps, insert_ns / ((double)reps * n),
+	          (double)insert_allocs / ((double)reps * n), tree, NULL);
+
+	// Queries: every entity queries its own bounds, as the collision pass does
+	const int max_results = n * 4;
+	const int stride = n > BENCH_ORACLE_QUERIES ? n / BENCH_ORACLE_QUERIES : 1;
+	unsigned char* marks = calloc(n, 1);
+
+	alloc_stats = (AllocStats){0};
+	long found = 0;
+	double t0 = now_ns();
+	for (int rep = 0; rep < reps; rep++) {
+		for (int i = 0; i < n; i++) {
+			found += quadtree_query(tree, bounds[i], results, max_results);
+		}
+	}
+	double query_ns = now_ns() - t0;
+
+	OracleStats oracle = {0};
+	for (int i = 0; i < n; i += stride) {
+		int count = quadtree_query(tree, bounds[i], results, max_results);
+		oracle_check(bounds, n, bounds[i], results, count, marks, &oracle);
+	}
+	print_row(out, "query", dist, n, reps, query_ns / ((double)reps * n),
+	          (double)alloc_stats.allocs / ((double)reps * n), tree, &oracle);
+
+	alloc_stats = (AllocStats){0};
+	long callback_found = 0;
+	t0 = now_ns();
+	for (int rep = 0; rep < reps; rep++) {
+		for (int i = 0; i < n; i++) {
+			CountContext ctx = {0, max_results};
+			quadtree_query_callback(tree, bounds[i], count_callback, &ctx);
+			callback_found += ctx.count;
+		}
+	}
+	double callback_ns = now_ns() - t0;
+
+	OracleStats callback_oracle = {0};
+	for (int i = 0; i < n; i += stride) {
+		CollectContext ctx = {results, 0, max_results};
+		quadtree_query_callback(tree, bounds[i], collect_callback, &ctx);
+		oracle_check(bounds, n, bounds[i], ctx.results, ctx.count, marks, &callback_oracle);
+	}
+	print_row(out, "query_callback", dist, n, reps, callback_ns / ((double)reps * n),
+	          (double)alloc_stats.allocs / ((double)reps * n), tree, &callback_oracle);
+
+	if (found != callback_found) {
+		fprintf(stderr, "warning: query and query_callback disagree (%ld vs %ld) for %s n=%d\n",
+		        found, callback_found, distribution_names[dist], n);
+	}
+
+	// Clear of the final tree, so single-rep sizes still get a sample
+	alloc_stats = (AllocStats){0};
+	t0 = now_ns();
+	quadtree_clear(tree);
+	clear_ns += now_ns() - t0;
+	clear_frees += alloc_stats.frees;
+	clears++;
+	print_row(out, "clear", dist, n, clears, clear_ns / clears, (double)clear_frees / clears, tree, NULL);
+
+	quadtree_destroy(tree);
+	free(marks);
+	free(results);
+	free(bounds);
+}
+
+// Usage: test_runner --bench [--max-n N] [--out FILE]
+int run_spatial_benchmarks(int argc, char** argv) {
+	int max_n = 100000;
+	FILE* out = stdout;
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--max-n") == 0 && i + 1 < argc) {
+			max_n = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+			out = fopen(argv[++i], "w");
+			if (!out) {
+				printf("Error: Cannot open %s\n", argv[i]);
+				return 1;
+			}
+		}
+	}
+
+	spatial_set_allocator(bench_alloc, bench_free);
+
+	fprintf(out, "op,distribution,n,reps,ns_per_op,allocs_per_op,nodes,max_depth,"
+	             "oracle_checked,oracle_missed,oracle_extra,duplicates\n");
+	bench_create(out);
+
+	for (int d = 0; d < BENCH_DISTRIBUTION_COUNT; d++) {
+		for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++) {
+			if (bench_sizes[s] > max_n) continue;
+			bench_size(out, (BenchDistribution)d, bench_sizes[s]);
+			fflush(out);
+		}
+	}
+
+	spatial_set_allocator(NULL, NULL);
+	if (out != stdout) fclose(out);
+	return 0;
+}
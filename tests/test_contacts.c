@@ -0,0 +1,135 @@
+#include "test_framework.h"
+#include "contacts.h"
+
+// Count events of one type in the last finished frame
+static int count_events(const ContactTable* table, ContactEventType type) {
+	int count = 0;
+	for (int i = 0; i < table->event_count; i++) {
+		if (table->events[i].type == type) count++;
+	}
+	return count;
+}
+
+TEST(test_contact_enter_stay_exit) {
+	ContactTable table = {0};
+
+	contact_table_begin_frame(&table);
+	Contact* c = contact_table_touch(&table, 7, 3);
+	ASSERT_TRUE(contact_is_new(&table, c));
+	ASSERT_TRUE(c->a == 3 && c->b == 7); // Keyed with the smaller id first
+	c->impact_speed = 2.0f;
+	contact_table_end_frame(&table);
+	ASSERT_EQ(1, count_events(&table, CONTACT_ENTER));
+
+	// Same pair in either order is the same contact, keeping its data across frames
+	contact_table_begin_frame(&table);
+	c = contact_table_touch(&table, 3, 7);
+	ASSERT_TRUE(!contact_is_new(&table, c));
+	ASSERT_TRUE(c->impact_speed == 2.0f);
+	c = contact_table_touch(&table, 7, 3);
+	ASSERT_TRUE(c->impact_speed == 2.0f);
+	contact_table_end_frame(&table);
+	ASSERT_EQ(0, count_events(&table, CONTACT_ENTER));
+	ASSERT_EQ(1, count_events(&table, CONTACT_STAY));
+
+	// Not touched: one exit, then gone
+	contact_table_begin_frame(&table);
+	contact_table_end_frame(&table);
+	ASSERT_EQ(1, count_events(&table, CONTACT_EXIT));
+	ASSERT_EQ(0, table.count);
+
+	contact_table_begin_frame(&table);
+	contact_table_end_frame(&table);
+	ASSERT_EQ(0, table.event_count);
+
+	contact_table_free(&table);
+}
+
+TEST(test_contact_table_growth) {
+	ContactTable table = {0};
+	const int pairs = 5000;
+
+	// Keep every other pair alive across a frame while the table grows
+	contact_table_begin_frame(&table);
+	for (int i = 1; i <= pairs; i++) {
+		contact_table_touch(&table, (uint64_t)i, (uint64_t)i + 100000)->impact_speed = (float)i;
+	}
+	contact_table_end_frame(&table);
+	ASSERT_EQ(pairs, count_events(&table, CONTACT_ENTER));
+
+	contact_table_begin_frame(&table);
+	int mismatches = 0;
+	for (int i = 2; i <= pairs; i += 2) {
+		Contact* c = contact_table_touch(&table, (uint64_t)i + 100000, (uint64_t)i);
+		if (c->impact_speed != (float)i) mismatches++;
+	}
+	contact_table_end_frame(&table);
+	ASSERT_EQ(0, mismatches);
+	ASSERT_EQ(pairs / 2, count_events(&table, CONTACT_STAY));
+	ASSERT_EQ(pairs / 2, count_events(&table, CONTACT_EXIT));
+	ASSERT_EQ(pairs / 2, table.count);
+
+	// Exits don't lose the survivors sharing their probe runs
+	contact_table_begin_frame(&table);
+	mismatches = 0;
+	for (int i = 2; i <= pairs; i += 2) {
+		if (i % 8 == 0) continue;
+		Contact* c = contact_table_touch(&table, (uint64_t)i, (uint64_t)i + 100000);
+		if (contact_is_new(&table, c) || c->impact_speed != (float)i) mismatches++;
+	}
+	contact_table_end_frame(&table);
+	ASSERT_EQ(0, mismatches);
+	ASSERT_EQ(0, count_events(&table, CONTACT_ENTER));
+	ASSERT_EQ(pairs / 8, count_events(&table, CONTACT_EXIT));
+	ASSERT_EQ(pairs / 2 - pairs / 8, table.count);
+
+	// Clearing forgets the survivors silently and keeps the storage
+	const int capacity = table.capacity;
+	contact_table_clear(&table);
+	ASSERT_EQ(0, table.count);
+	ASSERT_EQ(capacity, table.capacity);
+	contact_table_begin_frame(&table);
+	ASSERT_TRUE(contact_is_new(&table, contact_table_touch(&table, 2, 100002)));
+	contact_table_end_frame(&table);
+	ASSERT_EQ(1, count_events(&table, CONTACT_ENTER));
+	ASSERT_EQ(0, count_events(&table, CONTACT_EXIT));
+
+	contact_table_free(&table);
+}
+
+TEST(test_contact_hold) {
+	ContactTable table = {0};
+
+	contact_table_begin_frame(&table);
+	contact_table_touch(&table, 1, 2);
+	contact_table_touch(&table, 2, 3);
+	contact_table_touch(&table, 3, 4);
+	contact_table_end_frame(&table);
+
+	// 1, 2 and 3 sit the frame out: the pairs among them stay, the one with 4 exits
+	for (int frame = 0; frame < 3; frame++) {
+		contact_table_begin_frame(&table);
+		contact_table_hold(&table, 1);
+		contact_table_hold(&table, 2);
+		contact_table_hold(&table, 3);
+		contact_table_hold(&table, 3);
+		contact_table_end_frame(&table);
+		ASSERT_EQ(2, count_events(&table, CONTACT_STAY));
+		ASSERT_EQ(frame == 0 ? 1 : 0, count_events(&table, CONTACT_EXIT));
+	}
+
+	// Touched again later, a held pair is still the same contact
+	contact_table_begin_frame(&table);
+	ASSERT_TRUE(!contact_is_new(&table, contact_table_touch(&table, 2, 1)));
+	contact_table_end_frame(&table);
+	ASSERT_EQ(0, count_events(&table, CONTACT_ENTER));
+	ASSERT_EQ(1, count_events(&table, CONTACT_EXIT)); // 2-3: not held, not touched
+
+	contact_table_free(&table);
+}
+
+void run_contacts_tests(void) {
+	RUN_TEST(test_contact_enter_stay_exit);
+	RUN_TEST(test_contact_table_growth);
+	RUN_TEST(test_contact_hold);
+}
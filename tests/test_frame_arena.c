@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include <string.h>
+#include "test_framework.h"
+#include "frame_arena.h"
+#include "memtrack.h"
+
+TEST(test_frame_arena_alloc_reset) {
+	FrameArena arena = {0};
+
+	char* a = frame_arena_alloc(&arena, 3);
+	char* b = frame_arena_alloc(&arena, 40);
+	ASSERT_TRUE(a != NULL && b != NULL);
+	ASSERT_TRUE(((uintptr_t)a % FRAME_ARENA_ALIGNMENT) == 0);
+	ASSERT_TRUE(((uintptr_t)b % FRAME_ARENA_ALIGNMENT) == 0);
+	ASSERT_TRUE(b >= a + 3);
+	memset(a, 1, 3);
+	memset(b, 2, 40);
+
+	// A reset rewinds without touching the heap
+	const long long allocs = memtrack_stats(MEMTRACK_SCRATCH).allocs;
+	frame_arena_reset(&arena);
+	ASSERT_TRUE(frame_arena_alloc(&arena, 3) == a);
+	ASSERT_EQ(0, (int)(memtrack_stats(MEMTRACK_SCRATCH).allocs - allocs));
+
+	frame_arena_free(&arena);
+	ASSERT_TRUE(arena.base == NULL);
+}
+
+TEST(test_frame_arena_grows_to_peak) {
+	const long long live = memtrack_stats(MEMTRACK_SCRATCH).live_bytes;
+	FrameArena arena = {0};
+
+	// A frame bigger than the block spills into overflow blocks...
+	for (int i = 0; i < 8; i++) {
+		char* block = frame_arena_alloc(&arena, FRAME_ARENA_MIN_CAPACITY / 2);
+		ASSERT_TRUE(block != NULL);
+		memset(block, i, FRAME_ARENA_MIN_CAPACITY / 2);
+	}
+	ASSERT_TRUE(arena.overflow != NULL);
+
+	// ...and after a reset the same frame fits in one block, with no heap traffic
+	frame_arena_reset(&arena);
+	const long long allocs = memtrack_stats(MEMTRACK_SCRATCH).allocs;
+	for (int i = 0; i < 8; i++) {
+		frame_arena_alloc(&arena, FRAME_ARENA_MIN_CAPACITY / 2);
+	}
+	ASSERT_TRUE(arena.overflow == NULL);
+	frame_arena_reset(&arena);
+	ASSERT_EQ(0, (int)(memtrack_stats(MEMTRACK_SCRATCH).allocs - allocs));
+
+	frame_arena_free(&arena);
+	ASSERT_TRUE(memtrack_stats(MEMTRACK_SCRATCH).live_bytes == live);
+}
+
+TEST(test_frame_scratch_double_buffered) {
+	int* previous = frame_scratch_alloc(sizeof(int));
+	*previous = 42;
+	frame_scratch_swap();
+
+	// Last frame's data survives one swap...
+	int* current = frame_scratch_alloc(sizeof(int));
+	*current = 7;
+	ASSERT_EQ(42, *previous);
+	ASSERT_TRUE(current != previous);
+
+	// ...and its arena is reused after the next one
+	frame_scratch_swap();
+	ASSERT_TRUE(frame_scratch_alloc(sizeof(int)) == previous);
+	ASSERT_EQ(7, *current);
+
+	frame_scratch_free();
+}
+
+void run_frame_arena_tests(void) {
+	RUN_TEST(test_frame_arena_alloc_reset);
+	RUN_TEST(test_frame_arena_grows_to_peak);
+	RUN_TEST(test_frame_scratch_double_buffered);
+}
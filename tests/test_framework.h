@@ -17,6 +17,15 @@ extern int tests_failed;
 	} \
 } while (0)
 
+#define ASSERT_TRUE(condition) do { \
+	tests_run++; \
+	if (!(condition)) { \
+		printf("FAIL: %s:%d - Expected true: %s\n", \
+			__FILE__, __LINE__, #condition); \
+		tests_failed++; \
+	} \
+} while (0)
+
 #define RUN_TEST(test) do { \
 	printf("Running %s...\n", #test); \
 	test(); \
@@ -0,0 +1,102 @@
+#include <stdlib.h>
+#include "test_framework.h"
+#include "jobs.h"
+
+#define TEST_JOB_COUNT 1000
+#define TEST_RANGE_COUNT 100000
+
+static void mark_range(void* data, int begin, int end) {
+	atomic_int* hits = data;
+	for (int i = begin; i < end; i++) {
+		atomic_fetch_add(&hits[i], 1);
+	}
+}
+
+static void count_job(void* data) {
+	atomic_fetch_add((atomic_int*)data, 1);
+}
+
+typedef struct {
+	atomic_int stage;
+	int order_errors;
+} Chain;
+
+static void first_job(void* data) {
+	Chain* chain = data;
+	atomic_store(&chain->stage, 1);
+}
+
+static void second_job(void* data) {
+	Chain* chain = data;
+	if (atomic_load(&chain->stage) != 1) chain->order_errors++;
+	atomic_store(&chain->stage, 2);
+}
+
+// Every index is visited exactly once, inline or threaded
+static int parallel_for_misses(int count, int min_chunk) {
+	atomic_int* hits = calloc(count, sizeof(atomic_int));
+	jobs_parallel_for(count, min_chunk, mark_range, hits);
+
+	int misses = 0;
+	for (int i = 0; i < count; i++) {
+		if (atomic_load(&hits[i]) != 1) misses++;
+	}
+	free(hits);
+	return misses;
+}
+
+TEST(test_jobs_inline) {
+	// Without workers, jobs run on the caller as they are submitted
+	ASSERT_EQ(1, jobs_thread_count());
+
+	atomic_int runs = 0;
+	JobCounter counter = {0};
+	jobs_submit(count_job, &runs, &counter);
+	ASSERT_TRUE(jobs_done(&counter));
+	ASSERT_EQ(1, atomic_load(&runs));
+
+	ASSERT_EQ(0, parallel_for_misses(TEST_RANGE_COUNT, 64));
+}
+
+TEST(test_jobs_threaded) {
+	ASSERT_TRUE(jobs_init(3));
+	ASSERT_EQ(4, jobs_thread_count());
+
+	atomic_int runs = 0;
+	JobCounter counter = {0};
+	for (int i = 0; i < TEST_JOB_COUNT; i++) {
+		jobs_submit(count_job, &runs, &counter);
+	}
+	jobs_wait(&counter);
+	ASSERT_EQ(TEST_JOB_COUNT, atomic_load(&runs));
+
+	ASSERT_EQ(0, parallel_for_misses(TEST_RANGE_COUNT, 64));
+	ASSERT_EQ(0, parallel_for_misses(7, 1)); // Fewer items than chunks
+
+	// Dependencies: the second job only starts after the first finished
+	Chain chains[64];
+	JobCounter firsts[64];
+	JobCounter seconds = {0};
+	for (int i = 0; i < 64; i++) {
+		atomic_init(&chains[i].stage, 0);
+		chains[i].order_errors = 0;
+		firsts[i] = (JobCounter){0};
+		jobs_submit(first_job, &chains[i], &firsts[i]);
+		jobs_submit_after(&firsts[i], second_job, &chains[i], &seconds);
+	}
+	jobs_wait(&seconds);
+
+	int errors = 0;
+	for (int i = 0; i < 64; i++) {
+		if (chains[i].order_errors || atomic_load(&chains[i].stage) != 2) errors++;
+	}
+	ASSERT_EQ(0, errors);
+
+	jobs_shutdown();
+	ASSERT_EQ(1, jobs_thread_count());
+}
+
+void run_jobs_tests(void) {
+	RUN_TEST(test_jobs_inline);
+	RUN_TEST(test_jobs_threaded);
+}
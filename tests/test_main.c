@@ -1,3 +1,4 @@
+#include <string.h>
 #include "test_framework.h"
 
 int tests_run = 0;
@@ -5,11 +6,42 @@ int tests_failed = 0;
 
 // Declare test suite runners
 extern void run_module1_tests(void);
+extern void run_spatial_tests(void);
+extern void run_neighbors_tests(void);
+extern void run_contacts_tests(void);
+extern void run_jobs_tests(void);
+extern void run_profiler_tests(void);
+extern void run_memtrack_tests(void);
+extern void run_frame_arena_tests(void);
+extern void run_render_commands_tests(void);
+extern void run_soft_raster_tests(void);
+extern void run_rewind_tests(void);
+extern void run_replay_tests(void);
+extern void run_tween_tests(void);
+
+// Benchmarks (not run by default)
+extern int run_spatial_benchmarks(int argc, char** argv);
+
+int main(int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		return run_spatial_benchmarks(argc - 2, argv + 2);
+	}
 
-int main(void) {
 	printf("=== Running Tets Suite ===\n\n");
 
 	run_module1_tests();
+	run_spatial_tests();
+	run_neighbors_tests();
+	run_contacts_tests();
+	run_jobs_tests();
+	run_profiler_tests();
+	run_memtrack_tests();
+	run_frame_arena_tests();
+	run_render_commands_tests();
+	run_soft_raster_tests();
+	run_rewind_tests();
+	run_replay_tests();
+	run_tween_tests();
 
 	printf("\n=== Test Results ===\n");
 	printf("Tests run: %d\n", tests_run);
@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <string.h>
+#include "test_framework.h"
+#include "memtrack.h"
+#include "neighbors.h"
+
+TEST(test_memtrack_accounting) {
+	const MemTagStats before = memtrack_stats(MEMTRACK_SECTORS);
+	memtrack_frame_end();
+
+	char* block = memtrack_alloc(MEMTRACK_SECTORS, 1000);
+	ASSERT_TRUE(block != NULL);
+	ASSERT_TRUE(((uintptr_t)block % _Alignof(max_align_t)) == 0);
+	memset(block, 1, 1000);
+
+	MemTagStats stats = memtrack_stats(MEMTRACK_SECTORS);
+	ASSERT_EQ(1000, (int)(stats.live_bytes - before.live_bytes));
+	ASSERT_EQ(1, (int)(stats.allocs - before.allocs));
+
+	// Growing keeps the contents and the tag, whatever tag realloc is given
+	block = memtrack_realloc(MEMTRACK_FLECS, block, 4000);
+	ASSERT_TRUE(block[999] == 1);
+	stats = memtrack_stats(MEMTRACK_SECTORS);
+	ASSERT_EQ(4000, (int)(stats.live_bytes - before.live_bytes));
+	ASSERT_TRUE(stats.peak_bytes >= before.live_bytes + 4000);
+
+	int* zeros = memtrack_calloc(MEMTRACK_SECTORS, 16, sizeof(int));
+	int nonzero = 0;
+	for (int i = 0; i < 16; i++) nonzero += zeros[i] != 0;
+	ASSERT_EQ(0, nonzero);
+
+	memtrack_free(zeros);
+	memtrack_free(block);
+	memtrack_free(NULL);
+	stats = memtrack_stats(MEMTRACK_SECTORS);
+	ASSERT_EQ(0, (int)(stats.live_bytes - before.live_bytes));
+	ASSERT_EQ(3, (int)(stats.frees - before.frees));
+
+	// alloc + realloc + calloc during this frame
+	memtrack_frame_end();
+	ASSERT_EQ(3, (int)memtrack_stats(MEMTRACK_SECTORS).last_frame_allocs);
+	memtrack_frame_end();
+	ASSERT_EQ(0, (int)memtrack_stats(MEMTRACK_SECTORS).last_frame_allocs);
+}
+
+TEST(test_memtrack_neighbor_lists_tagged) {
+	const long long before = memtrack_stats(MEMTRACK_NEIGHBORS).live_bytes;
+
+	NeighborList list = {0};
+	neighbor_list_begin(&list, 100, 0.0f);
+	ASSERT_TRUE(memtrack_stats(MEMTRACK_NEIGHBORS).live_bytes > before);
+
+	neighbor_list_free(&list);
+	ASSERT_TRUE(memtrack_stats(MEMTRACK_NEIGHBORS).live_bytes == before);
+}
+
+void run_memtrack_tests(void) {
+	RUN_TEST(test_memtrack_accounting);
+	RUN_TEST(test_memtrack_neighbor_lists_tagged);
+}
@@ -0,0 +1,178 @@
+#include <string.h>
+#include <math.h>
+#include "test_framework.h"
+#include "neighbors.h"
+
+#define NEIGHBOR_TEST_COUNT 400
+
+#define NEIGHBOR_TEST_RADIUS 6.0f
+
+// Deterministic scatter of small circles over a 500x500 world
+static void make_bodies(Vector2* positions, int count) {
+	unsigned int seed = 777;
+	for (int i = 0; i < count; i++) {
+		seed = seed * 1103515245u + 12345u;
+		float x = (float)((seed >> 8) % 500);
+		seed = seed * 1103515245u + 12345u;
+		float y = (float)((seed >> 8) % 500);
+		positions[i] = (Vector2){x, y};
+	}
+}
+
+TEST(test_neighbor_list_matches_brute_force) {
+	Vector2 positions[NEIGHBOR_TEST_COUNT];
+	AABB bounds[NEIGHBOR_TEST_COUNT];
+	make_bodies(positions, NEIGHBOR_TEST_COUNT);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 500, 500});
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		bounds[i] = aabb_from_circle(positions[i], NEIGHBOR_TEST_RADIUS);
+		quadtree_insert(tree, i, bounds[i]);
+	}
+
+	NeighborList list = {0};
+	neighbor_list_begin(&list, NEIGHBOR_TEST_COUNT, 0.0f);
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		neighbor_list_append(&list, tree, i, positions[i], NEIGHBOR_TEST_RADIUS);
+	}
+	ASSERT_EQ(NEIGHBOR_TEST_COUNT, list.row_count);
+
+	// Every row holds exactly the other intersecting bodies, each once
+	int mismatches = 0;
+	char seen[NEIGHBOR_TEST_COUNT];
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		memset(seen, 0, sizeof(seen));
+		const int* row = neighbor_list_row(&list, i);
+		const int count = neighbor_list_count(&list, i);
+		for (int k = 0; k < count; k++) {
+			if (row[k] == i || seen[row[k]]) mismatches++;
+			seen[row[k]] = 1;
+		}
+		for (int j = 0; j < NEIGHBOR_TEST_COUNT; j++) {
+			const bool expected = j != i && aabb_intersects(bounds[i], bounds[j]);
+			if (expected != (bool)seen[j]) mismatches++;
+		}
+	}
+	ASSERT_EQ(0, mismatches);
+
+	// Rebuilding reuses the storage; bodies past row_count are ignored and
+	// empty rows keep the offsets consistent
+	neighbor_list_begin(&list, 2, 1000.0f);
+	neighbor_list_append_empty(&list, 0);
+	neighbor_list_append(&list, tree, 1, positions[1], NEIGHBOR_TEST_RADIUS);
+	ASSERT_EQ(0, neighbor_list_count(&list, 0));
+	ASSERT_EQ(1, neighbor_list_count(&list, 1));
+	ASSERT_EQ(0, neighbor_list_row(&list, 1)[0]);
+
+	neighbor_list_free(&list);
+	quadtree_destroy(tree);
+}
+
+TEST(test_neighbor_list_skin) {
+	Vector2 positions[NEIGHBOR_TEST_COUNT];
+	make_bodies(positions, NEIGHBOR_TEST_COUNT);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 500, 500});
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		quadtree_insert(tree, i, aabb_from_circle(positions[i], NEIGHBOR_TEST_RADIUS));
+	}
+
+	const float skin = 8.0f;
+	NeighborList list = {0};
+	neighbor_list_begin(&list, NEIGHBOR_TEST_COUNT, skin);
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		neighbor_list_append(&list, tree, i, positions[i], NEIGHBOR_TEST_RADIUS);
+	}
+
+	// Move every body by just under half the skin; no overlapping pair may be missing
+	unsigned int seed = 99;
+	int drifted = 0;
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		seed = seed * 1103515245u + 12345u;
+		const float angle = (float)(seed >> 8) * 0.001f;
+		positions[i].x += cosf(angle) * skin * 0.49f;
+		positions[i].y += sinf(angle) * skin * 0.49f;
+		if (neighbor_list_drift(&list, i, positions[i], NEIGHBOR_TEST_RADIUS) >= skin * 0.5f) drifted++;
+	}
+	ASSERT_EQ(0, drifted);
+
+	int missing = 0;
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		for (int j = 0; j < NEIGHBOR_TEST_COUNT; j++) {
+			const float dx = positions[j].x - positions[i].x;
+			const float dy = positions[j].y - positions[i].y;
+			if (j == i || sqrtf(dx * dx + dy * dy) > 2 * NEIGHBOR_TEST_RADIUS) continue;
+
+			bool listed = false;
+			const int* row = neighbor_list_row(&list, i);
+			for (int k = 0; k < neighbor_list_count(&list, i); k++) {
+				if (row[k] == j) listed = true;
+			}
+			if (!listed) missing++;
+		}
+	}
+	ASSERT_EQ(0, missing);
+
+	// Growing counts as drift too
+	ASSERT_TRUE(neighbor_list_drift(&list, 0, list.anchors[0].position, NEIGHBOR_TEST_RADIUS + 5.0f) >= 5.0f);
+
+	neighbor_list_free(&list);
+	quadtree_destroy(tree);
+}
+
+TEST(test_neighbor_list_padded_stale_tree) {
+	Vector2 positions[NEIGHBOR_TEST_COUNT];
+	make_bodies(positions, NEIGHBOR_TEST_COUNT);
+
+	// Tree of where the bodies were last frame
+	Quadtree* tree = quadtree_create((AABB){0, 0, 500, 500});
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		quadtree_insert(tree, i, aabb_from_circle(positions[i], NEIGHBOR_TEST_RADIUS));
+	}
+
+	// Every body has since moved by up to motion
+	const float motion = 5.0f;
+	unsigned int seed = 4242;
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		seed = seed * 1103515245u + 12345u;
+		const float angle = (float)(seed >> 8) * 0.001f;
+		positions[i].x += cosf(angle) * motion;
+		positions[i].y += sinf(angle) * motion;
+	}
+
+	NeighborList list = {0};
+	neighbor_list_begin(&list, NEIGHBOR_TEST_COUNT, 0.0f);
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		neighbor_list_append_padded(&list, tree, i, positions[i], NEIGHBOR_TEST_RADIUS, motion);
+	}
+
+	// Padding by the motion finds every pair overlapping at the new positions
+	int missing = 0;
+	for (int i = 0; i < NEIGHBOR_TEST_COUNT; i++) {
+		for (int j = 0; j < NEIGHBOR_TEST_COUNT; j++) {
+			const float dx = positions[j].x - positions[i].x;
+			const float dy = positions[j].y - positions[i].y;
+			if (j == i || sqrtf(dx * dx + dy * dy) > 2 * NEIGHBOR_TEST_RADIUS) continue;
+
+			bool listed = false;
+			const int* row = neighbor_list_row(&list, i);
+			for (int k = 0; k < neighbor_list_count(&list, i); k++) {
+				if (row[k] == j) listed = true;
+			}
+			if (!listed) missing++;
+		}
+	}
+	ASSERT_EQ(0, missing);
+
+	// Anchors keep the unpadded state, so drift is measured from the real radius
+	ASSERT_TRUE(list.anchors[0].radius == NEIGHBOR_TEST_RADIUS);
+
+	neighbor_list_free(&list);
+	quadtree_destroy(tree);
+}
+
+void run_neighbors_tests(void) {
+	RUN_TEST(test_neighbor_list_matches_brute_force);
+	RUN_TEST(test_neighbor_list_skin);
+	RUN_TEST(test_neighbor_list_padded_stale_tree);
+}
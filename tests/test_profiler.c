@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <string.h>
+#include "test_framework.h"
+#include "profiler.h"
+
+static const ProfilerZoneStats* find_zone(const ProfilerFrame* frame, const char* name) {
+	for (int i = 0; i < frame->zone_count; i++) {
+		if (strcmp(frame->zones[i].name, name) == 0) return &frame->zones[i];
+	}
+	return NULL;
+}
+
+static void scoped_work(void) {
+	PROFILE_ZONE("test_inner");
+	volatile double x = 0;
+	for (int i = 0; i < 10000; i++) x += i;
+}
+
+TEST(test_profiler_frame_breakdown) {
+	profiler_frame_end(); // Start a frame
+
+	for (int i = 0; i < 3; i++) {
+		PROFILE_BEGIN("test_outer");
+		scoped_work();
+		PROFILE_END();
+	}
+	profiler_frame_end();
+
+	const ProfilerFrame* frame = profiler_last_frame();
+	const ProfilerZoneStats* outer = find_zone(frame, "test_outer");
+	const ProfilerZoneStats* inner = find_zone(frame, "test_inner");
+	ASSERT_TRUE(outer != NULL && inner != NULL);
+	if (!outer || !inner) return;
+
+	ASSERT_EQ(3, outer->calls);
+	ASSERT_EQ(3, inner->calls);
+	// Zones are inclusive: the outer zone contains the scoped inner one
+	ASSERT_TRUE(outer->ms >= inner->ms);
+	ASSERT_TRUE(frame->frame_ms >= outer->ms);
+	ASSERT_TRUE(profiler_worst_frame()->frame_ms >= frame->frame_ms);
+
+	// Zones are only counted in the frame they ended in
+	profiler_frame_end();
+	ASSERT_TRUE(find_zone(profiler_last_frame(), "test_outer") == NULL);
+}
+
+TEST(test_profiler_trace) {
+	const char* path = "test_profiler_trace.json";
+
+	PROFILE_BEGIN("test_traced");
+	PROFILE_END();
+	profiler_frame_end();
+	ASSERT_TRUE(profiler_write_trace(path, 1));
+
+	FILE* file = fopen(path, "r");
+	ASSERT_TRUE(file != NULL);
+	if (!file) return;
+
+	char buffer[4096];
+	const size_t size = fread(buffer, 1, sizeof(buffer) - 1, file);
+	buffer[size] = '\0';
+	fclose(file);
+	remove(path);
+
+	ASSERT_TRUE(strncmp(buffer, "{\"traceEvents\":[", 16) == 0);
+	ASSERT_TRUE(strstr(buffer, "\"name\":\"test_traced\",\"ph\":\"X\"") != NULL);
+	// Older frames are left out
+	ASSERT_TRUE(strstr(buffer, "test_outer") == NULL);
+}
+
+void run_profiler_tests(void) {
+	RUN_TEST(test_profiler_frame_breakdown);
+	RUN_TEST(test_profiler_trace);
+}
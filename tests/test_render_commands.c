@@ -0,0 +1,68 @@
+#include "test_framework.h"
+#include "render_commands.h"
+
+static Color test_palette[RENDER_PALETTE_SIZE];
+
+TEST(test_render_commands_bucketed_by_key) {
+	RenderCommandBuffer buffer = {0};
+	render_commands_begin(&buffer, test_palette);
+
+	// Interleaved colors and layers, recorded bodies-first
+	for (int i = 0; i < 10; i++) {
+		render_circle(&buffer, RENDER_LAYER_BODIES, RENDER_FILL, i % 2 ? 4 : 2,
+		              (Vector2){(float)i, 0}, 5.0f, 255);
+	}
+	render_circle(&buffer, RENDER_LAYER_VFX, RENDER_OUTLINE, 4, (Vector2){100, 0}, 50.0f, 50);
+	render_circle(&buffer, RENDER_LAYER_VFX, RENDER_FILL, 4, (Vector2){100, 0}, 50.0f, 20);
+	ASSERT_EQ(12, buffer.count);
+
+	render_commands_sort(&buffer);
+
+	// VFX layer first, fill before outline, then bodies grouped by palette index
+	ASSERT_EQ(render_key(RENDER_LAYER_VFX, RENDER_FILL, 4), buffer.sorted[0].key);
+	ASSERT_EQ(render_key(RENDER_LAYER_VFX, RENDER_OUTLINE, 4), buffer.sorted[1].key);
+	for (int i = 2; i < 7; i++) {
+		ASSERT_EQ(render_key(RENDER_LAYER_BODIES, RENDER_FILL, 2), buffer.sorted[i].key);
+	}
+	for (int i = 7; i < 12; i++) {
+		ASSERT_EQ(render_key(RENDER_LAYER_BODIES, RENDER_FILL, 4), buffer.sorted[i].key);
+	}
+
+	// Stable: recording order is kept within a bucket
+	ASSERT_TRUE(buffer.sorted[2].position.x == 0 && buffer.sorted[6].position.x == 8);
+	ASSERT_TRUE(buffer.sorted[7].position.x == 1 && buffer.sorted[11].position.x == 9);
+
+	const unsigned char bodies2 = render_key(RENDER_LAYER_BODIES, RENDER_FILL, 2);
+	ASSERT_EQ(2, buffer.bucket_start[bodies2]);
+	ASSERT_EQ(7, buffer.bucket_start[bodies2 + 1]);
+
+	// Points sort after fills and outlines of their layer
+	const unsigned char point = render_key(RENDER_LAYER_BODIES, RENDER_POINT, 31);
+	ASSERT_EQ(RENDER_POINT, render_key_shape(point));
+	ASSERT_TRUE(point > render_key(RENDER_LAYER_BODIES, RENDER_OUTLINE, 31));
+
+	// A new frame starts empty but keeps its storage
+	render_commands_begin(&buffer, test_palette);
+	ASSERT_EQ(0, buffer.count);
+	ASSERT_TRUE(buffer.capacity > 0);
+
+	render_commands_free(&buffer);
+}
+
+TEST(test_render_commands_grow) {
+	RenderCommandBuffer buffer = {0};
+	render_commands_begin(&buffer, test_palette);
+	for (int i = 0; i < 5000; i++) {
+		render_circle(&buffer, RENDER_LAYER_BODIES, RENDER_FILL, i % RENDER_PALETTE_SIZE,
+		              (Vector2){(float)i, 0}, 1.0f, 255);
+	}
+	render_commands_submit(&buffer);
+	ASSERT_EQ(5000, buffer.count);
+	ASSERT_EQ(5000, buffer.bucket_start[RENDER_KEY_COUNT]);
+	render_commands_free(&buffer);
+}
+
+void run_render_commands_tests(void) {
+	RUN_TEST(test_render_commands_bucketed_by_key);
+	RUN_TEST(test_render_commands_grow);
+}
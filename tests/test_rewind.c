@@ -0,0 +1,142 @@
+#include <string.h>
+#include "test_framework.h"
+#include "rewind.h"
+#include "memtrack.h"
+
+#define REWIND_TEST_SIZE 4096
+
+// Deterministic pseudo-random bytes
+static void fill_state(unsigned char* state, size_t size, unsigned int seed) {
+	for (size_t i = 0; i < size; i++) {
+		seed = seed * 1103515245u + 12345u;
+		state[i] = (unsigned char)(seed >> 16);
+	}
+}
+
+// Change a few scattered bytes, as one simulation tick would
+static void perturb_state(unsigned char* state, size_t size, unsigned int seed) {
+	for (int k = 0; k < 16; k++) {
+		seed = seed * 1103515245u + 12345u;
+		state[(seed >> 8) % size] ^= (unsigned char)(1 + k);
+	}
+}
+
+static bool round_trip(const unsigned char* older, size_t older_size, const unsigned char* newer, size_t newer_size,
+                       size_t* delta_size) {
+	RewindBlob delta = {0};
+	RewindBlob decoded = {0};
+	bool ok = rewind_delta_encode(older, older_size, newer, newer_size, &delta) &&
+	          rewind_delta_apply(delta.data, delta.size, newer, newer_size, &decoded) &&
+	          decoded.size == older_size &&
+	          (older_size == 0 || memcmp(decoded.data, older, older_size) == 0);
+	if (delta_size) *delta_size = delta.size;
+	memtrack_free(delta.data);
+	memtrack_free(decoded.data);
+	return ok;
+}
+
+TEST(test_rewind_delta_round_trip) {
+	static unsigned char older[REWIND_TEST_SIZE];
+	static unsigned char newer[REWIND_TEST_SIZE + 512];
+	fill_state(older, REWIND_TEST_SIZE, 1);
+	memcpy(newer, older, REWIND_TEST_SIZE);
+	fill_state(newer + REWIND_TEST_SIZE, 512, 2);
+
+	// Identical states cost a handful of bytes
+	size_t delta_size = 0;
+	ASSERT_TRUE(round_trip(older, REWIND_TEST_SIZE, newer, REWIND_TEST_SIZE, &delta_size));
+	ASSERT_TRUE(delta_size < 8);
+
+	// A few changed bytes cost a few runs
+	perturb_state(newer, REWIND_TEST_SIZE, 3);
+	ASSERT_TRUE(round_trip(older, REWIND_TEST_SIZE, newer, REWIND_TEST_SIZE, &delta_size));
+	ASSERT_TRUE(delta_size < 16 * 8);
+
+	// The state may grow or shrink between steps, or differ throughout
+	ASSERT_TRUE(round_trip(older, REWIND_TEST_SIZE, newer, REWIND_TEST_SIZE + 512, NULL));
+	ASSERT_TRUE(round_trip(older, REWIND_TEST_SIZE, newer, 1000, NULL));
+	ASSERT_TRUE(round_trip(older, REWIND_TEST_SIZE, newer, 0, NULL));
+	ASSERT_TRUE(round_trip(older, 0, newer, REWIND_TEST_SIZE, NULL));
+	fill_state(newer, REWIND_TEST_SIZE, 4);
+	ASSERT_TRUE(round_trip(older, REWIND_TEST_SIZE, newer, REWIND_TEST_SIZE, &delta_size));
+	ASSERT_TRUE(delta_size < REWIND_TEST_SIZE + 64);
+
+	// Short equal runs, including one ending the state
+	unsigned char a[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+	unsigned char b[12] = {1, 0, 3, 0, 0, 6, 7, 0, 9, 10, 11, 12};
+	ASSERT_TRUE(round_trip(a, sizeof(a), b, sizeof(b), NULL));
+	ASSERT_TRUE(round_trip(b, sizeof(b), a, sizeof(a), NULL));
+	b[11] = 0;
+	ASSERT_TRUE(round_trip(a, sizeof(a), b, sizeof(b), NULL));
+}
+
+TEST(test_rewind_delta_rejects_malformed) {
+	static unsigned char older[REWIND_TEST_SIZE];
+	static unsigned char newer[REWIND_TEST_SIZE];
+	fill_state(older, REWIND_TEST_SIZE, 5);
+	memcpy(newer, older, REWIND_TEST_SIZE);
+	perturb_state(newer, REWIND_TEST_SIZE, 6);
+
+	RewindBlob delta = {0};
+	RewindBlob decoded = {0};
+	ASSERT_TRUE(rewind_delta_encode(older, REWIND_TEST_SIZE, newer, REWIND_TEST_SIZE, &delta));
+
+	// Truncated anywhere, or with trailing garbage
+	int accepted = 0;
+	for (size_t size = 0; size < delta.size; size++) {
+		if (rewind_delta_apply(delta.data, size, newer, REWIND_TEST_SIZE, &decoded)) accepted++;
+	}
+	ASSERT_EQ(0, accepted);
+	ASSERT_TRUE(!rewind_delta_apply(delta.data, delta.size - 1, newer, REWIND_TEST_SIZE, &decoded));
+
+	// Equal runs reaching past the newer state
+	ASSERT_TRUE(!rewind_delta_apply(delta.data, delta.size, newer, REWIND_TEST_SIZE / 2, &decoded));
+
+	const unsigned char huge[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+	ASSERT_TRUE(!rewind_delta_apply(huge, sizeof(huge), newer, REWIND_TEST_SIZE, &decoded));
+
+	memtrack_free(delta.data);
+	memtrack_free(decoded.data);
+}
+
+TEST(test_rewind_buffer_steps_back) {
+	const long long live = memtrack_stats(MEMTRACK_SNAPSHOT).live_bytes;
+	static unsigned char states[6][REWIND_TEST_SIZE];
+	fill_state(states[0], REWIND_TEST_SIZE, 7);
+	for (int s = 1; s < 6; s++) {
+		memcpy(states[s], states[s - 1], REWIND_TEST_SIZE);
+		perturb_state(states[s], REWIND_TEST_SIZE, 100 + s);
+	}
+
+	RewindBuffer buffer;
+	ASSERT_TRUE(rewind_init(&buffer, 3));
+	ASSERT_TRUE(!rewind_step_back(&buffer));
+
+	// Six states into a buffer keeping three besides the newest: the first two are dropped
+	for (int s = 0; s < 6; s++) {
+		ASSERT_TRUE(rewind_push(&buffer, states[s], REWIND_TEST_SIZE));
+	}
+	ASSERT_EQ(3, buffer.count);
+	ASSERT_TRUE(rewind_bytes(&buffer) < REWIND_TEST_SIZE + 3 * 16 * 8);
+
+	for (int s = 5; s > 2; s--) {
+		ASSERT_TRUE(buffer.head.size == REWIND_TEST_SIZE && memcmp(buffer.head.data, states[s], REWIND_TEST_SIZE) == 0);
+		ASSERT_TRUE(rewind_step_back(&buffer));
+	}
+	ASSERT_TRUE(memcmp(buffer.head.data, states[2], REWIND_TEST_SIZE) == 0);
+	ASSERT_TRUE(!rewind_step_back(&buffer));
+
+	// Pushing after stepping back continues from the restored state
+	ASSERT_TRUE(rewind_push(&buffer, states[5], REWIND_TEST_SIZE));
+	ASSERT_TRUE(rewind_step_back(&buffer));
+	ASSERT_TRUE(memcmp(buffer.head.data, states[2], REWIND_TEST_SIZE) == 0);
+
+	rewind_free(&buffer);
+	ASSERT_TRUE(memtrack_stats(MEMTRACK_SNAPSHOT).live_bytes == live);
+}
+
+void run_rewind_tests(void) {
+	RUN_TEST(test_rewind_delta_round_trip);
+	RUN_TEST(test_rewind_delta_rejects_malformed);
+	RUN_TEST(test_rewind_buffer_steps_back);
+}
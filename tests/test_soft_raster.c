@@ -0,0 +1,119 @@
+#include "test_framework.h"
+#include "soft_raster.h"
+
+#define GOLDEN_HASH 0x83663d29u
+
+static bool same_color(Color a, Color b) {
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+TEST(test_soft_raster_circle_coverage) {
+	SoftFramebuffer fb;
+	ASSERT_TRUE(soft_framebuffer_init(&fb, 64, 64));
+	soft_clear(&fb, BLACK);
+
+	const Color red = {255, 0, 0, 255};
+	soft_fill_circle(&fb, (Vector2){32, 32}, 10.0f, red);
+
+	int covered = 0;
+	for (int y = 0; y < fb.height; y++) {
+		for (int x = 0; x < fb.width; x++) {
+			covered += same_color(soft_pixel(&fb, x, y), red);
+		}
+	}
+	// pi * r^2 = 314, within the error of point sampling the edge
+	ASSERT_TRUE(covered > 300 && covered < 330);
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 32, 32), red));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 32, 42), BLACK));
+
+	// Circles partly off the framebuffer are clipped, not wrapped
+	soft_fill_circle(&fb, (Vector2){-5, 70}, 12.0f, red);
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 63, 60), BLACK));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 0, 63), red));
+
+	soft_framebuffer_free(&fb);
+}
+
+TEST(test_soft_raster_blend_matches_scalar) {
+	SoftFramebuffer fb;
+	ASSERT_TRUE(soft_framebuffer_init(&fb, 16, 2));
+	soft_clear(&fb, (Color){100, 100, 100, 255});
+
+	// 13 wide: vector steps plus a scalar tail
+	soft_fill_rectangle(&fb, (Rectangle){1, 0, 13, 1}, (Color){200, 0, 50, 128});
+
+	const Color expected = {
+		(unsigned char)((200 * 128 + 100 * 127 + 127) / 255),
+		(unsigned char)((0 * 128 + 100 * 127 + 127) / 255),
+		(unsigned char)((50 * 128 + 100 * 127 + 127) / 255),
+		255
+	};
+	int matching = 0;
+	for (int x = 1; x < 14; x++) {
+		matching += same_color(soft_pixel(&fb, x, 0), expected);
+	}
+	ASSERT_EQ(13, matching);
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 0, 0), ((Color){100, 100, 100, 255})));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 14, 0), ((Color){100, 100, 100, 255})));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 5, 1), ((Color){100, 100, 100, 255})));
+
+	soft_framebuffer_free(&fb);
+}
+
+TEST(test_soft_raster_outlines) {
+	SoftFramebuffer fb;
+	ASSERT_TRUE(soft_framebuffer_init(&fb, 64, 64));
+	soft_clear(&fb, BLACK);
+
+	soft_circle_lines(&fb, (Vector2){32, 32}, 20.0f, WHITE);
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 51, 32), WHITE));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 32, 12), WHITE));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 32, 32), BLACK));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 45, 32), BLACK));
+
+	soft_rectangle_lines(&fb, (Rectangle){2, 2, 10, 10}, 2.0f, WHITE);
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 2, 2), WHITE));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 11, 11), WHITE));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 3, 7), WHITE));
+	ASSERT_TRUE(same_color(soft_pixel(&fb, 6, 6), BLACK));
+
+	soft_framebuffer_free(&fb);
+}
+
+// A small scene through the command buffer, compared against a golden hash.
+// If this fails after an intended change, look at the written PPM first.
+TEST(test_soft_raster_golden_frame) {
+	Color palette[RENDER_PALETTE_SIZE];
+	for (int i = 0; i < RENDER_PALETTE_SIZE; i++) {
+		palette[i] = (Color){(unsigned char)(i * 8), (unsigned char)(255 - i * 8), (unsigned char)(i * 37), 255};
+	}
+
+	RenderCommandBuffer buffer = {0};
+	render_commands_begin(&buffer, palette);
+	render_circle(&buffer, RENDER_LAYER_BODIES, RENDER_FILL, 2, (Vector2){40, 30}, 12.0f, 255);
+	render_circle(&buffer, RENDER_LAYER_BODIES, RENDER_FILL, 5, (Vector2){50, 36}, 8.5f, 255);
+	render_circle(&buffer, RENDER_LAYER_VFX, RENDER_OUTLINE, 4, (Vector2){48, 32}, 28.0f, 50);
+	render_circle(&buffer, RENDER_LAYER_VFX, RENDER_FILL, 4, (Vector2){48, 32}, 28.0f, 20);
+
+	SoftFramebuffer fb;
+	ASSERT_TRUE(soft_framebuffer_init(&fb, 96, 64));
+	soft_clear(&fb, (Color){20, 20, 30, 255});
+	render_commands_raster(&buffer, &fb);
+
+	const uint32_t hash = soft_framebuffer_hash(&fb);
+	if (hash != GOLDEN_HASH) {
+		printf("golden frame hash %08x, written to test_soft_raster_golden.ppm\n", hash);
+		soft_framebuffer_write_ppm(&fb, "test_soft_raster_golden.ppm");
+	}
+	ASSERT_TRUE(hash == GOLDEN_HASH);
+
+	soft_framebuffer_free(&fb);
+	render_commands_free(&buffer);
+}
+
+void run_soft_raster_tests(void) {
+	RUN_TEST(test_soft_raster_circle_coverage);
+	RUN_TEST(test_soft_raster_blend_matches_scalar);
+	RUN_TEST(test_soft_raster_outlines);
+	RUN_TEST(test_soft_raster_golden_frame);
+}
@@ -0,0 +1,303 @@
+#include <stdlib.h>
+#include <math.h>
+#include "test_framework.h"
+#include "spatial.h"
+
+#define TEST_ENTITY_COUNT 500
+
+static int alloc_count = 0;
+static int free_count = 0;
+
+static void* counting_alloc(size_t size) {
+	alloc_count++;
+	return malloc(size);
+}
+
+static void counting_free(void* ptr) {
+	if (ptr) free_count++;
+	free(ptr);
+}
+
+static void count_callback(int entity_index, void* user_data) {
+	(void)entity_index;
+	(*(int*)user_data)++;
+}
+
+// Deterministic scatter of small circles over a 1000x1000 world
+static void make_entities(AABB* bounds, int count) {
+	unsigned int seed = 12345;
+	for (int i = 0; i < count; i++) {
+		seed = seed * 1103515245u + 12345u;
+		float x = (float)((seed >> 8) % 1000);
+		seed = seed * 1103515245u + 12345u;
+		float y = (float)((seed >> 8) % 1000);
+		bounds[i] = aabb_from_circle((Vector2){x, y}, 8.0f);
+	}
+}
+
+// Count distinct indices in a result list (queries may report an entity once per leaf)
+static int count_unique(int* results, int count, int entity_count) {
+	char* seen = calloc(entity_count, 1);
+	int unique = 0;
+	for (int i = 0; i < count; i++) {
+		if (!seen[results[i]]) {
+			seen[results[i]] = 1;
+			unique++;
+		}
+	}
+	free(seen);
+	return unique;
+}
+
+TEST(test_aabb_intersects) {
+	AABB a = {0, 0, 10, 10};
+	ASSERT_TRUE(aabb_intersects(a, (AABB){5, 5, 15, 15}));
+	ASSERT_TRUE(aabb_intersects(a, (AABB){10, 10, 20, 20})); // Touching edges count
+	ASSERT_TRUE(!aabb_intersects(a, (AABB){11, 0, 20, 10}));
+	ASSERT_TRUE(aabb_contains_point(a, (Vector2){5, 5}));
+	ASSERT_TRUE(!aabb_contains_point(a, (Vector2){-1, 5}));
+}
+
+TEST(test_quadtree_query_matches_brute_force) {
+	AABB bounds[TEST_ENTITY_COUNT];
+	make_entities(bounds, TEST_ENTITY_COUNT);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 1000, 1000});
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		quadtree_insert(tree, i, bounds[i]);
+	}
+	ASSERT_EQ(TEST_ENTITY_COUNT, tree->total_entities);
+
+	int results[TEST_ENTITY_COUNT * 4];
+	int mismatches = 0;
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		int expected = 0;
+		for (int j = 0; j < TEST_ENTITY_COUNT; j++) {
+			if (aabb_intersects(bounds[i], bounds[j])) expected++;
+		}
+
+		int count = quadtree_query(tree, bounds[i], results, TEST_ENTITY_COUNT * 4);
+		if (count_unique(results, count, TEST_ENTITY_COUNT) != expected) mismatches++;
+	}
+	ASSERT_EQ(0, mismatches);
+
+	quadtree_destroy(tree);
+}
+
+TEST(test_quadtree_query_callback_matches_query) {
+	AABB bounds[TEST_ENTITY_COUNT];
+	make_entities(bounds, TEST_ENTITY_COUNT);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 1000, 1000});
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		quadtree_insert(tree, i, bounds[i]);
+	}
+
+	int results[TEST_ENTITY_COUNT * 4];
+	AABB query = {200, 200, 600, 500};
+	int count = quadtree_query(tree, query, results, TEST_ENTITY_COUNT * 4);
+	int callback_count = 0;
+	quadtree_query_callback(tree, query, count_callback, &callback_count);
+	ASSERT_EQ(count, callback_count);
+
+	quadtree_destroy(tree);
+}
+
+typedef struct {
+	int times_seen[TEST_ENTITY_COUNT];
+	int singles;
+	int clusters;
+	int clustered;
+} ClusterTally;
+
+static void tally_single(int index, void* user_data) {
+	ClusterTally* tally = user_data;
+	tally->times_seen[index]++;
+	tally->singles++;
+}
+
+static void tally_cluster(Vector2 centroid, float radius, int count, int first_index, void* user_data) {
+	ClusterTally* tally = user_data;
+	tally->clusters++;
+	tally->clustered += count;
+	tally->times_seen[first_index]++;
+}
+
+TEST(test_quadtree_query_clustered_reports_once) {
+	AABB bounds[TEST_ENTITY_COUNT];
+	make_entities(bounds, TEST_ENTITY_COUNT);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 1000, 1000});
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		quadtree_insert(tree, i, bounds[i]);
+	}
+	const AABB everything = {0, 0, 1000, 1000};
+
+	// No clustering: every entity exactly once, even those straddling nodes
+	ClusterTally tally = {0};
+	quadtree_query_clustered(tree, everything, 0.0f, tally_single, tally_cluster, &tally);
+	int once = 0;
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) once += tally.times_seen[i] == 1;
+	ASSERT_EQ(TEST_ENTITY_COUNT, once);
+	ASSERT_EQ(0, tally.clusters);
+
+	// Coarse clustering: far fewer reports, but every entity still accounted for once
+	tally = (ClusterTally){0};
+	quadtree_query_clustered(tree, everything, 300.0f, tally_single, tally_cluster, &tally);
+	ASSERT_TRUE(tally.clusters > 0);
+	ASSERT_TRUE(tally.singles + tally.clusters < TEST_ENTITY_COUNT / 4);
+	ASSERT_EQ(TEST_ENTITY_COUNT, tally.singles + tally.clustered);
+
+	quadtree_destroy(tree);
+}
+
+TEST(test_quadtree_clear_resets) {
+	AABB bounds[TEST_ENTITY_COUNT];
+	make_entities(bounds, TEST_ENTITY_COUNT);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 1000, 1000});
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		quadtree_insert(tree, i, bounds[i]);
+	}
+	ASSERT_TRUE(tree->node_count > 1);
+
+	quadtree_clear(tree);
+	ASSERT_EQ(0, tree->total_entities);
+	ASSERT_EQ(1, tree->node_count);
+
+	int results[16];
+	ASSERT_EQ(0, quadtree_query(tree, (AABB){0, 0, 1000, 1000}, results, 16));
+
+	quadtree_destroy(tree);
+}
+
+TEST(test_spatial_allocator_hook) {
+	AABB bounds[TEST_ENTITY_COUNT];
+	make_entities(bounds, TEST_ENTITY_COUNT);
+
+	alloc_count = 0;
+	free_count = 0;
+	spatial_set_allocator(counting_alloc, counting_free);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 1000, 1000});
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		quadtree_insert(tree, i, bounds[i]);
+	}
+	// One allocation for the tree itself plus one per node
+	ASSERT_EQ(tree->node_count + 1, alloc_count);
+
+	quadtree_destroy(tree);
+	ASSERT_EQ(alloc_count, free_count);
+
+	spatial_set_allocator(NULL, NULL);
+}
+
+TEST(test_quadtree_degenerate_keeps_all) {
+	// Identical bounds can't be split apart; max-depth leaves must overflow, not drop
+	Quadtree* tree = quadtree_create((AABB){0, 0, 1000, 1000});
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		quadtree_insert(tree, i, aabb_from_circle((Vector2){300, 300}, 8.0f));
+	}
+
+	int results[TEST_ENTITY_COUNT * 4];
+	int count = quadtree_query(tree, (AABB){290, 290, 310, 310}, results, TEST_ENTITY_COUNT * 4);
+	ASSERT_EQ(TEST_ENTITY_COUNT, count_unique(results, count, TEST_ENTITY_COUNT));
+
+	quadtree_destroy(tree);
+}
+
+// Brute-force softened inverse-square sum, matching quadtree_gravity
+static Vector2 direct_gravity(const AABB* bounds, int count, int self, float softening) {
+	Vector2 acc = {0, 0};
+	const Vector2 p = {(bounds[self].x_min + bounds[self].x_max) * 0.5f,
+	                   (bounds[self].y_min + bounds[self].y_max) * 0.5f};
+	for (int j = 0; j < count; j++) {
+		if (j == self) continue;
+		const float dx = (bounds[j].x_min + bounds[j].x_max) * 0.5f - p.x;
+		const float dy = (bounds[j].y_min + bounds[j].y_max) * 0.5f - p.y;
+		const float d = sqrtf(dx * dx + dy * dy + softening * softening);
+		acc.x += dx / (d * d * d);
+		acc.y += dy / (d * d * d);
+	}
+	return acc;
+}
+
+TEST(test_quadtree_gravity) {
+	AABB bounds[TEST_ENTITY_COUNT];
+	make_entities(bounds, TEST_ENTITY_COUNT);
+
+	Quadtree* tree = quadtree_create((AABB){0, 0, 1000, 1000});
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		quadtree_insert_with_mass(tree, i, bounds[i], 1.0f);
+	}
+	quadtree_compute_mass(tree);
+	ASSERT_TRUE(fabsf(tree->root->mass - TEST_ENTITY_COUNT) < 0.01f);
+
+	int exact_errors = 0;
+	double error_sq = 0.0, magnitude_sq = 0.0;
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		const Vector2 p = {(bounds[i].x_min + bounds[i].x_max) * 0.5f,
+		                   (bounds[i].y_min + bounds[i].y_max) * 0.5f};
+		const Vector2 expected = direct_gravity(bounds, TEST_ENTITY_COUNT, i, 10.0f);
+		const float magnitude = sqrtf(expected.x * expected.x + expected.y * expected.y);
+
+		// Opening angle 0 never approximates, so it must match the direct sum
+		const Vector2 exact = quadtree_gravity(tree, p, i, 0.0f, 10.0f);
+		if (fabsf(exact.x - expected.x) > 1e-3f * magnitude + 1e-7f ||
+		    fabsf(exact.y - expected.y) > 1e-3f * magnitude + 1e-7f) {
+			exact_errors++;
+		}
+
+		const Vector2 approx = quadtree_gravity(tree, p, i, 0.5f, 10.0f);
+		error_sq += (approx.x - expected.x) * (approx.x - expected.x) +
+		            (approx.y - expected.y) * (approx.y - expected.y);
+		magnitude_sq += magnitude * magnitude;
+	}
+	ASSERT_EQ(0, exact_errors);
+	// Opening angle 0.5 approximates: require a small relative RMS error overall
+	ASSERT_TRUE(sqrt(error_sq / magnitude_sq) < 0.02);
+
+	quadtree_destroy(tree);
+}
+
+TEST(test_morton_sort) {
+	AABB bounds[TEST_ENTITY_COUNT];
+	make_entities(bounds, TEST_ENTITY_COUNT);
+
+	const AABB world = {0, 0, 1000, 1000};
+	unsigned int codes[TEST_ENTITY_COUNT];
+	for (int i = 0; i < TEST_ENTITY_COUNT; i++) {
+		codes[i] = spatial_morton_code(world, (Vector2){bounds[i].x_min + 8.0f, bounds[i].y_min + 8.0f});
+	}
+
+	// Z-order: x on the even bits, y on the odd bits, clamped to the world
+	ASSERT_EQ(0, (int)spatial_morton_code(world, (Vector2){-50, -50}));
+	ASSERT_EQ(1, (int)(spatial_morton_code(world, (Vector2){1000, 0}) & 3));
+	ASSERT_EQ(2, (int)(spatial_morton_code(world, (Vector2){0, 1000}) & 3));
+
+	int order[TEST_ENTITY_COUNT];
+	spatial_sort_by_code(codes, TEST_ENTITY_COUNT, order);
+
+	char seen[TEST_ENTITY_COUNT] = {0};
+	int errors = 0;
+	for (int k = 0; k < TEST_ENTITY_COUNT; k++) {
+		if (seen[order[k]]) errors++;
+		seen[order[k]] = 1;
+		if (k > 0 && codes[order[k]] < codes[order[k - 1]]) errors++;
+		// Stable: equal codes keep index order
+		if (k > 0 && codes[order[k]] == codes[order[k - 1]] && order[k] < order[k - 1]) errors++;
+	}
+	ASSERT_EQ(0, errors);
+}
+
+void run_spatial_tests(void) {
+	RUN_TEST(test_aabb_intersects);
+	RUN_TEST(test_quadtree_query_matches_brute_force);
+	RUN_TEST(test_quadtree_query_callback_matches_query);
+	RUN_TEST(test_quadtree_query_clustered_reports_once);
+	RUN_TEST(test_quadtree_clear_resets);
+	RUN_TEST(test_spatial_allocator_hook);
+	RUN_TEST(test_quadtree_degenerate_keeps_all);
+	RUN_TEST(test_quadtree_gravity);
+	RUN_TEST(test_morton_sort);
+}
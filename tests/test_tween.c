@@ -0,0 +1,171 @@
+#include <math.h>
+#include <string.h>
+#include "test_framework.h"
+#include "tween.h"
+#include "memtrack.h"
+
+// Semi-implicit Euler with a tiny step, as a reference for the closed form
+static void integrate(float stiffness, float damping, float* x, float* v, float target, float time) {
+	const int steps = 20000;
+	const double dt = time / steps;
+	double xd = *x, vd = *v;
+	for (int s = 0; s < steps; s++) {
+		vd += (-stiffness * (xd - target) - damping * vd) * dt;
+		xd += vd * dt;
+	}
+	*x = (float)xd;
+	*v = (float)vd;
+}
+
+TEST(test_tween_matches_integration) {
+	TweenPool pool = {0};
+	// Underdamped, critically damped and overdamped
+	const float stiffness[3] = {700.0f, 100.0f, 100.0f};
+	const float damping[3] = {11.5f, 20.0f, 60.0f};
+	TweenHandle handles[3];
+	for (int p = 0; p < 3; p++) {
+		const int profile = tween_profile(&pool, stiffness[p], damping[p]);
+		handles[p] = tween_start(&pool, profile, (uint64_t)p, 5.0f, 0.0f, 15.0f);
+		ASSERT_TRUE(handles[p] != 0);
+	}
+
+	const float dt = 1.0f / 60.0f;
+	tween_update(&pool, dt);
+	ASSERT_EQ(3, pool.count);
+	for (int i = 0; i < pool.count; i++) {
+		const int p = (int)pool.owner[i];
+		float x = 5.0f, v = 0.0f;
+		integrate(stiffness[p], damping[p], &x, &v, 15.0f, dt);
+		ASSERT_TRUE(fabsf(pool.value[i] - x) < 0.01f);
+		ASSERT_TRUE(fabsf(pool.velocity[i] - v) < 0.5f);
+	}
+
+	// Every spring settles on its target
+	int finished = 0;
+	for (int frame = 0; frame < 600 && pool.count > 0; frame++) {
+		tween_update(&pool, dt);
+		for (int f = 0; f < pool.finished_count; f++) {
+			ASSERT_TRUE(pool.finished[f].value == 15.0f);
+			finished++;
+		}
+	}
+	ASSERT_EQ(3, finished);
+	for (int p = 0; p < 3; p++) {
+		ASSERT_TRUE(!tween_running(&pool, handles[p], (uint64_t)p));
+	}
+
+	tween_pool_free(&pool);
+}
+
+TEST(test_tween_handles) {
+	const long long live = memtrack_stats(MEMTRACK_ANIMATION).live_bytes;
+	TweenPool pool = {0};
+	const int profile = tween_profile(&pool, 700.0f, 11.5f);
+	ASSERT_EQ(profile, tween_profile(&pool, 700.0f, 11.5f));
+	ASSERT_TRUE(tween_profile(&pool, 1000.0f, 18.4f) != profile);
+	ASSERT_TRUE(tween_start(&pool, TWEEN_MAX_PROFILES, 0, 0.0f, 0.0f, 1.0f) == 0);
+	ASSERT_TRUE(!tween_running(&pool, 0, 0));
+
+	TweenHandle handles[100];
+	for (int i = 0; i < 100; i++) {
+		handles[i] = tween_start(&pool, profile, (uint64_t)i, 0.0f, 0.0f, (float)i);
+	}
+	ASSERT_EQ(100, pool.count);
+
+	// Stopping swaps the last spring into the hole; the others keep their handles
+	for (int i = 0; i < 100; i += 2) {
+		tween_stop(&pool, handles[i], (uint64_t)i);
+	}
+	tween_stop(&pool, handles[0], 0);
+	ASSERT_EQ(50, pool.count);
+	int running = 0;
+	for (int i = 0; i < 100; i++) {
+		if (tween_running(&pool, handles[i], (uint64_t)i)) running++;
+	}
+	ASSERT_EQ(50, running);
+	for (int i = 0; i < pool.count; i++) {
+		ASSERT_TRUE(pool.owner[i] % 2 == 1 && pool.target[i] == (float)pool.owner[i]);
+	}
+
+	// Freed slots are reused under a new generation, so old handles stay stale
+	const int slots = pool.slot_count;
+	const TweenHandle reused = tween_start(&pool, profile, 1000, 0.0f, 0.0f, 1.0f);
+	ASSERT_EQ(slots, pool.slot_count);
+	ASSERT_TRUE(tween_running(&pool, reused, 1000));
+	for (int i = 0; i < 100; i += 2) {
+		ASSERT_TRUE(handles[i] != reused && !tween_running(&pool, handles[i], (uint64_t)i));
+	}
+
+	// Once the generation wraps, a stale handle matches again, but not its owner
+	tween_stop(&pool, reused, 1000);
+	TweenHandle wrapped = 0;
+	for (int n = 0; n < 5000 && wrapped != reused; n++) {
+		tween_stop(&pool, wrapped, 2000);
+		wrapped = tween_start(&pool, profile, 2000, 0.0f, 0.0f, 1.0f);
+	}
+	ASSERT_TRUE(wrapped == reused);
+	ASSERT_TRUE(!tween_running(&pool, reused, 1000));
+	tween_stop(&pool, reused, 1000); // The old owner's stale handle...
+	ASSERT_TRUE(tween_running(&pool, wrapped, 2000)); // ...leaves this spring alone
+
+	tween_pool_clear(&pool);
+	ASSERT_EQ(0, pool.count);
+	ASSERT_TRUE(!tween_running(&pool, wrapped, 2000) && !tween_running(&pool, handles[1], 1));
+
+	tween_pool_free(&pool);
+	ASSERT_TRUE(memtrack_stats(MEMTRACK_ANIMATION).live_bytes == live);
+}
+
+TEST(test_tween_save_load) {
+	TweenPool pool = {0};
+	const int profile = tween_profile(&pool, 700.0f, 11.5f);
+	TweenHandle handles[10];
+	for (int i = 0; i < 10; i++) {
+		handles[i] = tween_start(&pool, profile, (uint64_t)i, 0.0f, (float)i, 10.0f);
+	}
+	tween_stop(&pool, handles[3], 3);
+	tween_stop(&pool, handles[7], 7);
+	tween_update(&pool, 1.0f / 60.0f);
+
+	const size_t size = tween_pool_save(&pool, NULL);
+	unsigned char data[1024];
+	ASSERT_TRUE(size <= sizeof(data));
+	ASSERT_TRUE(tween_pool_save(&pool, data) == size);
+
+	// The copy carries on exactly like the original, handles included
+	TweenPool copy = {0};
+	ASSERT_TRUE(tween_pool_load(&copy, data, size));
+	for (int i = 0; i < 10; i++) {
+		ASSERT_TRUE(tween_running(&copy, handles[i], (uint64_t)i) == tween_running(&pool, handles[i], (uint64_t)i));
+	}
+	tween_update(&pool, 1.0f / 60.0f);
+	tween_update(&copy, 1.0f / 60.0f);
+	ASSERT_EQ(pool.count, copy.count);
+	ASSERT_TRUE(memcmp(pool.value, copy.value, sizeof(float) * pool.count) == 0);
+	ASSERT_TRUE(tween_start(&copy, profile, 99, 0.0f, 0.0f, 1.0f) == tween_start(&pool, profile, 99, 0.0f, 0.0f, 1.0f));
+
+	// Truncated or inconsistent data is refused and leaves the pool alone
+	const int count = copy.count;
+	int accepted = 0;
+	for (size_t s = 0; s < size; s++) {
+		if (tween_pool_load(&copy, data, s)) accepted++;
+	}
+	ASSERT_EQ(0, accepted);
+	unsigned char broken[1024];
+	memcpy(broken, data, size);
+	broken[size - 1] = TWEEN_MAX_PROFILES; // A spring's profile
+	ASSERT_TRUE(!tween_pool_load(&copy, broken, size));
+	memcpy(broken, data, size);
+	broken[8] = 0; // Free list head
+	ASSERT_TRUE(!tween_pool_load(&copy, broken, size));
+	ASSERT_EQ(count, copy.count);
+
+	tween_pool_free(&pool);
+	tween_pool_free(&copy);
+}
+
+void run_tween_tests(void) {
+	RUN_TEST(test_tween_matches_integration);
+	RUN_TEST(test_tween_handles);
+	RUN_TEST(test_tween_save_load);
+}